@@ -73,16 +73,16 @@ struct BlifDumper
 		sig.optimize();
 		log_assert(sig.width == 1);
 
-		if (sig.chunks.at(0).wire == NULL)
-			return sig.chunks.at(0).data.bits.at(0) == RTLIL::State::S1 ?  "$true" : "$false";
+		if (sig.chunks().at(0).wire == NULL)
+			return sig.chunks().at(0).data.bits.at(0) == RTLIL::State::S1 ?  "$true" : "$false";
 
-		std::string str = RTLIL::unescape_id(sig.chunks.at(0).wire->name);
+		std::string str = RTLIL::unescape_id(sig.chunks().at(0).wire->name);
 		for (size_t i = 0; i < str.size(); i++)
 			if (str[i] == '#' || str[i] == '=')
 				str[i] = '?';
 
-		if (sig.chunks.at(0).wire->width != 1)
-			str += stringf("[%d]", sig.chunks.at(0).offset);
+		if (sig.chunks().at(0).wire->width != 1)
+			str += stringf("[%d]", sig.chunks().at(0).offset);
 
 		cstr_buf.push_back(str);
 		return cstr_buf.back().c_str();
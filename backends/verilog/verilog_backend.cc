@@ -134,22 +134,22 @@ std::string id(std::string internal_id, bool may_rename = true)
 bool is_reg_wire(RTLIL::SigSpec sig, std::string &reg_name)
 {
 	sig.optimize();
-	if (sig.chunks.size() != 1 || sig.chunks[0].wire == NULL)
+	if (sig.chunks().size() != 1 || sig.chunks()[0].wire == NULL)
 		return false;
-	if (reg_wires.count(sig.chunks[0].wire->name) == 0)
+	if (reg_wires.count(sig.chunks()[0].wire->name) == 0)
 		return false;
-	reg_name = id(sig.chunks[0].wire->name);
-	if (sig.width != sig.chunks[0].wire->width) {
+	reg_name = id(sig.chunks()[0].wire->name);
+	if (sig.width != sig.chunks()[0].wire->width) {
 		if (sig.width == 1)
-			reg_name += stringf("[%d]", sig.chunks[0].wire->start_offset +  sig.chunks[0].offset);
+			reg_name += stringf("[%d]", sig.chunks()[0].wire->start_offset +  sig.chunks()[0].offset);
 		else
-			reg_name += stringf("[%d:%d]", sig.chunks[0].wire->start_offset +  sig.chunks[0].offset + sig.chunks[0].width - 1,
-					sig.chunks[0].wire->start_offset +  sig.chunks[0].offset);
+			reg_name += stringf("[%d:%d]", sig.chunks()[0].wire->start_offset +  sig.chunks()[0].offset + sig.chunks()[0].width - 1,
+					sig.chunks()[0].wire->start_offset +  sig.chunks()[0].offset);
 	}
 	return true;
 }
 
-void dump_const(FILE *f, RTLIL::Const &data, int width = -1, int offset = 0, bool no_decimal = false, bool set_signed = false)
+void dump_const(FILE *f, const RTLIL::Const &data, int width = -1, int offset = 0, bool no_decimal = false, bool set_signed = false)
 {
 	if (width < 0)
 		width = data.bits.size() - offset;
@@ -203,7 +203,7 @@ void dump_const(FILE *f, RTLIL::Const &data, int width = -1, int offset = 0, boo
 	}
 }
 
-void dump_sigchunk(FILE *f, RTLIL::SigChunk &chunk, bool no_decimal = false)
+void dump_sigchunk(FILE *f, const RTLIL::SigChunk &chunk, bool no_decimal = false)
 {
 	if (chunk.wire == NULL) {
 		dump_const(f, chunk.data, chunk.width, chunk.offset, no_decimal);
@@ -221,12 +221,12 @@ void dump_sigchunk(FILE *f, RTLIL::SigChunk &chunk, bool no_decimal = false)
 
 void dump_sigspec(FILE *f, RTLIL::SigSpec &sig)
 {
-	if (sig.chunks.size() == 1) {
-		dump_sigchunk(f, sig.chunks[0]);
+	if (sig.chunks().size() == 1) {
+		dump_sigchunk(f, sig.chunks()[0]);
 	} else {
 		fprintf(f, "{ ");
-		for (auto it = sig.chunks.rbegin(); it != sig.chunks.rend(); it++) {
-			if (it != sig.chunks.rbegin())
+		for (auto it = sig.chunks().rbegin(); it != sig.chunks().rend(); it++) {
+			if (it != sig.chunks().rbegin())
 				fprintf(f, ", ");
 			dump_sigchunk(f, *it, true);
 		}
@@ -304,7 +304,7 @@ std::string cellname(RTLIL::Cell *cell)
 			goto no_special_reg_name;
 
 		sig.optimize();
-		RTLIL::Wire *wire = sig.chunks[0].wire;
+		RTLIL::Wire *wire = sig.chunks()[0].wire;
 
 		if (wire->name[0] != '\\')
 			goto no_special_reg_name;
@@ -318,7 +318,7 @@ std::string cellname(RTLIL::Cell *cell)
 			cell_name = cell_name + "_reg";
 
 		if (wire->width != 1)
-			cell_name += stringf("[%d]", wire->start_offset + sig.chunks[0].offset);
+			cell_name += stringf("[%d]", wire->start_offset + sig.chunks()[0].offset);
 
 		if (active_module && active_module->count_id(cell_name) > 0)
 				goto no_special_reg_name;
@@ -791,9 +791,9 @@ void case_body_find_regs(RTLIL::CaseRule *cs)
 		case_body_find_regs(*it2);
 
 	for (auto it = cs->actions.begin(); it != cs->actions.end(); it++) {
-		for (size_t i = 0; i < it->first.chunks.size(); i++)
-			if (it->first.chunks[i].wire)
-				reg_wires.insert(it->first.chunks[i].wire->name);
+		for (size_t i = 0; i < it->first.chunks().size(); i++)
+			if (it->first.chunks()[i].wire)
+				reg_wires.insert(it->first.chunks()[i].wire->name);
 	}
 }
 
@@ -803,9 +803,9 @@ void dump_process(FILE *f, std::string indent, RTLIL::Process *proc, bool find_r
 		case_body_find_regs(&proc->root_case);
 		for (auto it = proc->syncs.begin(); it != proc->syncs.end(); it++)
 		for (auto it2 = (*it)->actions.begin(); it2 != (*it)->actions.end(); it2++) {
-			for (size_t i = 0; i < it2->first.chunks.size(); i++)
-				if (it2->first.chunks[i].wire)
-					reg_wires.insert(it2->first.chunks[i].wire->name);
+			for (size_t i = 0; i < it2->first.chunks().size(); i++)
+				if (it2->first.chunks()[i].wire)
+					reg_wires.insert(it2->first.chunks()[i].wire->name);
 		}
 		return;
 	}
@@ -891,9 +891,9 @@ void dump_module(FILE *f, std::string indent, RTLIL::Module *module)
 			RTLIL::SigSpec sig = cell->connections["\\Q"];
 			sig.optimize();
 
-			if (sig.chunks.size() == 1 && sig.chunks[0].wire)
-				for (int i = 0; i < sig.chunks[0].width; i++)
-					reg_bits.insert(std::pair<RTLIL::Wire*,int>(sig.chunks[0].wire, sig.chunks[0].offset+i));
+			if (sig.chunks().size() == 1 && sig.chunks()[0].wire)
+				for (int i = 0; i < sig.chunks()[0].width; i++)
+					reg_bits.insert(std::pair<RTLIL::Wire*,int>(sig.chunks()[0].wire, sig.chunks()[0].offset+i));
 		}
 		for (auto &it : module->wires)
 		{
@@ -994,9 +994,9 @@ struct VerilogBackend : public Backend {
 
 		reg_ct.clear();
 		reg_ct.setup_stdcells_mem();
-		reg_ct.cell_types.insert("$sr");
-		reg_ct.cell_types.insert("$dff");
-		reg_ct.cell_types.insert("$adff");
+		reg_ct.setup_type("$sr");
+		reg_ct.setup_type("$dff");
+		reg_ct.setup_type("$adff");
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++) {
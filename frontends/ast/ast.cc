@@ -887,7 +887,7 @@ AstModule::~AstModule()
 }
 
 // create a new parametric module (when needed) and return the name of the generated module
-RTLIL::IdString AstModule::derive(RTLIL::Design *design, std::map<RTLIL::IdString, RTLIL::Const> parameters)
+RTLIL::IdString AstModule::derive(RTLIL::Design *design, HashMap<RTLIL::IdString, RTLIL::Const> parameters)
 {
 	std::string stripped_name = name;
 
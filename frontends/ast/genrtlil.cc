@@ -61,9 +61,7 @@ static RTLIL::SigSpec uniop2rtlil(AstNode *that, std::string type, int result_wi
 	chunk.width = wire->width;
 	chunk.offset = 0;
 
-	RTLIL::SigSpec sig;
-	sig.chunks.push_back(chunk);
-	sig.width = chunk.width;
+	RTLIL::SigSpec sig(chunk);
 
 	if (gen_attributes)
 		for (auto &attr : that->attributes) {
@@ -110,9 +108,7 @@ static void widthExtend(AstNode *that, RTLIL::SigSpec &sig, int width, bool is_s
 	chunk.width = wire->width;
 	chunk.offset = 0;
 
-	RTLIL::SigSpec new_sig;
-	new_sig.chunks.push_back(chunk);
-	new_sig.width = chunk.width;
+	RTLIL::SigSpec new_sig(chunk);
 
 	if (that != NULL)
 		for (auto &attr : that->attributes) {
@@ -154,9 +150,7 @@ static RTLIL::SigSpec binop2rtlil(AstNode *that, std::string type, int result_wi
 	chunk.width = wire->width;
 	chunk.offset = 0;
 
-	RTLIL::SigSpec sig;
-	sig.chunks.push_back(chunk);
-	sig.width = chunk.width;
+	RTLIL::SigSpec sig(chunk);
 
 	for (auto &attr : that->attributes) {
 		if (attr.second->type != AST_CONSTANT)
@@ -204,9 +198,7 @@ static RTLIL::SigSpec mux2rtlil(AstNode *that, const RTLIL::SigSpec &cond, const
 	chunk.width = wire->width;
 	chunk.offset = 0;
 
-	RTLIL::SigSpec sig;
-	sig.chunks.push_back(chunk);
-	sig.width = chunk.width;
+	RTLIL::SigSpec sig(chunk);
 
 	for (auto &attr : that->attributes) {
 		if (attr.second->type != AST_CONSTANT)
@@ -332,9 +324,9 @@ struct AST_INTERNAL::ProcessGenerator
 			init_rvalue.optimize();
 
 			int offset = 0;
-			for (size_t i = 0; i < init_lvalue.chunks.size(); i++) {
-				RTLIL::SigSpec lhs = init_lvalue.chunks[i];
-				RTLIL::SigSpec rhs = init_rvalue.extract(offset, init_lvalue.chunks[i].width);
+			for (size_t i = 0; i < init_lvalue.chunks().size(); i++) {
+				RTLIL::SigSpec lhs = init_lvalue.chunks()[i];
+				RTLIL::SigSpec rhs = init_rvalue.extract(offset, init_lvalue.chunks()[i].width);
 				sync->actions.push_back(RTLIL::SigSig(lhs, rhs));
 				offset += lhs.width;
 			}
@@ -344,10 +336,10 @@ struct AST_INTERNAL::ProcessGenerator
 	// create new temporary signals
 	RTLIL::SigSpec new_temp_signal(RTLIL::SigSpec sig)
 	{
-		sig.optimize();
-		for (size_t i = 0; i < sig.chunks.size(); i++)
+		std::vector<RTLIL::SigChunk> chunks = sig.chunks();
+		for (size_t i = 0; i < chunks.size(); i++)
 		{
-			RTLIL::SigChunk &chunk = sig.chunks[i];
+			RTLIL::SigChunk &chunk = chunks[i];
 			if (chunk.wire == NULL)
 				continue;
 
@@ -365,7 +357,7 @@ struct AST_INTERNAL::ProcessGenerator
 			chunk.wire = wire;
 			chunk.offset = 0;
 		}
-		return sig;
+		return chunks;
 	}
 
 	// recursively traverse the AST an collect all assigned signals
@@ -436,10 +428,10 @@ struct AST_INTERNAL::ProcessGenerator
 		rvalue.optimize();
 
 		int offset = 0;
-		for (size_t i = 0; i < lvalue.chunks.size(); i++) {
-			RTLIL::SigSpec lhs = lvalue.chunks[i];
-			RTLIL::SigSpec rhs = rvalue.extract(offset, lvalue.chunks[i].width);
-			if (inSyncRule && lvalue.chunks[i].wire && lvalue.chunks[i].wire->get_bool_attribute("\\nosync"))
+		for (size_t i = 0; i < lvalue.chunks().size(); i++) {
+			RTLIL::SigSpec lhs = lvalue.chunks()[i];
+			RTLIL::SigSpec rhs = rvalue.extract(offset, lvalue.chunks()[i].width);
+			if (inSyncRule && lvalue.chunks()[i].wire && lvalue.chunks()[i].wire->get_bool_attribute("\\nosync"))
 				rhs = RTLIL::SigSpec(RTLIL::State::Sx, rhs.width);
 			actions.push_back(RTLIL::SigSig(lhs, rhs));
 			offset += lhs.width;
@@ -978,9 +970,7 @@ RTLIL::SigSpec AstNode::genRTLIL(int width_hint, bool sign_hint)
 				}
 			}
 
-			RTLIL::SigSpec sig;
-			sig.chunks.push_back(chunk);
-			sig.width = chunk.width;
+			RTLIL::SigSpec sig(chunk);
 
 			if (genRTLIL_subst_from && genRTLIL_subst_to)
 				sig.replace(*genRTLIL_subst_from, *genRTLIL_subst_to);
@@ -1002,13 +992,9 @@ RTLIL::SigSpec AstNode::genRTLIL(int width_hint, bool sign_hint)
 	// concatenation of signals can be done directly using RTLIL::SigSpec
 	case AST_CONCAT: {
 			RTLIL::SigSpec sig;
-			sig.width = 0;
 			for (auto it = children.begin(); it != children.end(); it++) {
 				RTLIL::SigSpec s = (*it)->genRTLIL();
-				for (size_t i = 0; i < s.chunks.size(); i++) {
-					sig.chunks.push_back(s.chunks[i]);
-					sig.width += s.chunks[i].width;
-				}
+				sig.append(s);
 			}
 			if (sig.width < width_hint)
 				sig.extend_u0(width_hint, false);
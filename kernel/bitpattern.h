@@ -34,13 +34,9 @@ struct BitPatternPool
 		width = sig.width;
 		if (width > 0) {
 			std::vector<RTLIL::State> pattern(width);
-			sig.optimize();
 			for (int i = 0; i < width; i++) {
-				RTLIL::SigSpec s = sig.extract(i, 1);
-				s.optimize();
-				assert(s.chunks.size() == 1);
-				if (s.chunks[0].wire == NULL && s.chunks[0].data.bits[0] <= RTLIL::State::S1)
-					pattern[i] = s.chunks[0].data.bits[0];
+				if (sig[i].wire == NULL && sig[i].data <= RTLIL::State::S1)
+					pattern[i] = sig[i].data;
 				else
 					pattern[i] = RTLIL::State::Sa;
 			}
@@ -61,10 +57,8 @@ struct BitPatternPool
 
 	bits_t sig2bits(RTLIL::SigSpec sig)
 	{
-		sig.optimize();
 		assert(sig.is_fully_const());
-		assert(sig.chunks.size() == 1);
-		bits_t bits = sig.chunks[0].data.bits;
+		bits_t bits = sig.as_const().bits;
 		for (auto &b : bits)
 			if (b > RTLIL::State::S1)
 				b = RTLIL::State::Sa;
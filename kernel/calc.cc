@@ -25,6 +25,8 @@
 #include "kernel/rtlil.h"
 #include "libs/bigint/BigIntegerLibrary.hh"
 #include <assert.h>
+#include <string.h>
+#include <stdint.h>
 
 static void extend(RTLIL::Const &arg, int width, bool is_signed)
 {
@@ -99,6 +101,127 @@ static RTLIL::Const big2const(const BigInteger &val, int result_len, int undef_b
 	return result;
 }
 
+// Fast path for constant folding: fully defined operands that fit into a
+// 64 bit signed integer are evaluated with native integer arithmetic. The
+// calculations are done in a type that is wide enough to hold the exact sum
+// or product of two such operands. Everything else goes through BigInteger.
+
+#ifdef __SIZEOF_INT128__
+typedef __int128 fast_int_t;
+typedef unsigned __int128 fast_uint_t;
+#  define FAST_INT_OPERAND_BITS 64
+#else
+typedef int64_t fast_int_t;
+typedef uint64_t fast_uint_t;
+#  define FAST_INT_OPERAND_BITS 32
+#endif
+
+bool RTLIL::const_disable_fastpath = false;
+
+static bool const2fast(const RTLIL::Const &val, bool as_signed, fast_int_t &result)
+{
+	if (RTLIL::const_disable_fastpath)
+		return false;
+
+	size_t width = val.bits.size();
+	RTLIL::State padding = width > 0 && as_signed ? val.bits.back() : RTLIL::State::S0;
+
+	for (size_t i = FAST_INT_OPERAND_BITS-1; i < width; i++)
+		if (val.bits[i] != padding)
+			return false;
+
+	result = 0;
+	for (size_t i = std::min(width, size_t(FAST_INT_OPERAND_BITS)); i > 0; i--) {
+		if (val.bits[i-1] > RTLIL::State::S1)
+			return false;
+		result = (result << 1) | (val.bits[i-1] == RTLIL::State::S1 ? 1 : 0);
+	}
+
+	if (padding == RTLIL::State::S1 && width < FAST_INT_OPERAND_BITS)
+		result -= fast_int_t(1) << width;
+	if (padding == RTLIL::State::S1 && width >= FAST_INT_OPERAND_BITS)
+		result -= fast_int_t(1) << FAST_INT_OPERAND_BITS;
+
+	return true;
+}
+
+static RTLIL::Const fast2const(fast_int_t val, int result_len)
+{
+	const int max_shift = 8*sizeof(fast_int_t) - 1;
+	RTLIL::Const result(RTLIL::State::S0, result_len);
+	for (int i = 0; i < result_len; i++)
+		if (((val >> std::min(i, max_shift)) & 1) != 0)
+			result.bits[i] = RTLIL::State::S1;
+	return result;
+}
+
+// RTLIL::State uses one byte per bit. The following helpers operate on eight
+// states at once, loaded into a 64 bit word. The masks returned by is_s0()
+// and is_s1() contain 0xff in each byte that holds an S0 (or S1) state.
+
+static const uint64_t bytes_01 = 0x0101010101010101ULL;
+static const uint64_t bytes_7f = 0x7f7f7f7f7f7f7f7fULL;
+static const uint64_t bytes_80 = 0x8080808080808080ULL;
+
+static inline uint64_t load_word(const RTLIL::State *p)
+{
+	uint64_t w;
+	memcpy(&w, p, 8);
+	return w;
+}
+
+static inline void store_word(RTLIL::State *p, uint64_t w)
+{
+	memcpy(p, &w, 8);
+}
+
+static inline uint64_t is_zero_byte(uint64_t w)
+{
+	uint64_t t = ~(((w & bytes_7f) + bytes_7f) | w) & bytes_80;
+	return (t >> 7) * 0xff;
+}
+
+static inline uint64_t is_s0(uint64_t w)
+{
+	return is_zero_byte(w);
+}
+
+static inline uint64_t is_s1(uint64_t w)
+{
+	return is_zero_byte(w ^ bytes_01);
+}
+
+// builds a word with S1 in the bytes set in mask_s1, S0 in the bytes set in
+// mask_s0 and Sx in all other bytes (the masks must not overlap)
+static inline uint64_t make_word(uint64_t mask_s0, uint64_t mask_s1)
+{
+	return ((RTLIL::State::Sx * bytes_01) & ~(mask_s0 | mask_s1)) | (bytes_01 & mask_s1);
+}
+
+static uint64_t logic_and_word(uint64_t a, uint64_t b)
+{
+	return make_word(is_s0(a) | is_s0(b), is_s1(a) & is_s1(b));
+}
+
+static uint64_t logic_or_word(uint64_t a, uint64_t b)
+{
+	return make_word(is_s0(a) & is_s0(b), is_s1(a) | is_s1(b));
+}
+
+static uint64_t logic_xor_word(uint64_t a, uint64_t b)
+{
+	uint64_t defined = (is_s0(a) | is_s1(a)) & (is_s0(b) | is_s1(b));
+	uint64_t ones = is_s1(a) ^ is_s1(b);
+	return make_word(defined & ~ones, defined & ones);
+}
+
+static uint64_t logic_xnor_word(uint64_t a, uint64_t b)
+{
+	uint64_t defined = (is_s0(a) | is_s1(a)) & (is_s0(b) | is_s1(b));
+	uint64_t ones = is_s1(a) ^ is_s1(b);
+	return make_word(defined & ones, defined & ~ones);
+}
+
 static RTLIL::State logic_and(RTLIL::State a, RTLIL::State b)
 {
 	if (a == RTLIL::State::S0) return RTLIL::State::S0;
@@ -140,7 +263,13 @@ RTLIL::Const RTLIL::const_not(const RTLIL::Const &arg1, const RTLIL::Const&, boo
 	extend_u0(arg1_ext, result_len, signed1);
 
 	RTLIL::Const result(RTLIL::State::Sx, result_len);
-	for (size_t i = 0; i < size_t(result_len); i++) {
+	size_t i = 0;
+	if (arg1_ext.bits.size() >= size_t(result_len))
+		for (; i+8 <= size_t(result_len); i += 8) {
+			uint64_t a = load_word(&arg1_ext.bits[i]);
+			store_word(&result.bits[i], make_word(is_s1(a), is_s0(a)));
+		}
+	for (; i < size_t(result_len); i++) {
 		if (i >= arg1_ext.bits.size())
 			result.bits[i] = RTLIL::State::S0;
 		else if (arg1_ext.bits[i] == RTLIL::State::S0)
@@ -152,7 +281,7 @@ RTLIL::Const RTLIL::const_not(const RTLIL::Const &arg1, const RTLIL::Const&, boo
 	return result;
 }
 
-static RTLIL::Const logic_wrapper(RTLIL::State(*logic_func)(RTLIL::State, RTLIL::State),
+static RTLIL::Const logic_wrapper(RTLIL::State(*logic_func)(RTLIL::State, RTLIL::State), uint64_t(*logic_word_func)(uint64_t, uint64_t),
 		RTLIL::Const arg1, RTLIL::Const arg2, bool signed1, bool signed2, int result_len = -1)
 {
 	if (result_len < 0)
@@ -162,7 +291,11 @@ static RTLIL::Const logic_wrapper(RTLIL::State(*logic_func)(RTLIL::State, RTLIL:
 	extend_u0(arg2, result_len, signed2);
 
 	RTLIL::Const result(RTLIL::State::Sx, result_len);
-	for (size_t i = 0; i < size_t(result_len); i++) {
+	size_t i = 0;
+	if (arg1.bits.size() >= size_t(result_len) && arg2.bits.size() >= size_t(result_len))
+		for (; i+8 <= size_t(result_len); i += 8)
+			store_word(&result.bits[i], logic_word_func(load_word(&arg1.bits[i]), load_word(&arg2.bits[i])));
+	for (; i < size_t(result_len); i++) {
 		RTLIL::State a = i < arg1.bits.size() ? arg1.bits[i] : RTLIL::State::S0;
 		RTLIL::State b = i < arg2.bits.size() ? arg2.bits[i] : RTLIL::State::S0;
 		result.bits[i] = logic_func(a, b);
@@ -173,29 +306,39 @@ static RTLIL::Const logic_wrapper(RTLIL::State(*logic_func)(RTLIL::State, RTLIL:
 
 RTLIL::Const RTLIL::const_and(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_and, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(logic_and, logic_and_word, arg1, arg2, signed1, signed2, result_len);
 }
 
 RTLIL::Const RTLIL::const_or(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_or, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(logic_or, logic_or_word, arg1, arg2, signed1, signed2, result_len);
 }
 
 RTLIL::Const RTLIL::const_xor(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_xor, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(logic_xor, logic_xor_word, arg1, arg2, signed1, signed2, result_len);
 }
 
 RTLIL::Const RTLIL::const_xnor(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_xnor, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(logic_xnor, logic_xnor_word, arg1, arg2, signed1, signed2, result_len);
 }
 
-static RTLIL::Const logic_reduce_wrapper(RTLIL::State initial, RTLIL::State(*logic_func)(RTLIL::State, RTLIL::State), const RTLIL::Const &arg1, int result_len)
+static RTLIL::Const logic_reduce_wrapper(RTLIL::State initial, RTLIL::State(*logic_func)(RTLIL::State, RTLIL::State), uint64_t(*logic_word_func)(uint64_t, uint64_t),
+		const RTLIL::Const &arg1, int result_len)
 {
 	RTLIL::State temp = initial;
+	size_t i = 0;
+
+	if (arg1.bits.size() >= 8) {
+		uint64_t temp_word = initial * bytes_01;
+		for (; i+8 <= arg1.bits.size(); i += 8)
+			temp_word = logic_word_func(temp_word, load_word(&arg1.bits[i]));
+		for (int k = 0; k < 8; k++)
+			temp = logic_func(temp, RTLIL::State((temp_word >> (8*k)) & 0xff));
+	}
 
-	for (size_t i = 0; i < arg1.bits.size(); i++)
+	for (; i < arg1.bits.size(); i++)
 		temp = logic_func(temp, arg1.bits[i]);
 
 	RTLIL::Const result(temp);
@@ -206,22 +349,22 @@ static RTLIL::Const logic_reduce_wrapper(RTLIL::State initial, RTLIL::State(*log
 
 RTLIL::Const RTLIL::const_reduce_and(const RTLIL::Const &arg1, const RTLIL::Const&, bool, bool, int result_len)
 {
-	return logic_reduce_wrapper(RTLIL::State::S1, logic_and, arg1, result_len);
+	return logic_reduce_wrapper(RTLIL::State::S1, logic_and, logic_and_word, arg1, result_len);
 }
 
 RTLIL::Const RTLIL::const_reduce_or(const RTLIL::Const &arg1, const RTLIL::Const&, bool, bool, int result_len)
 {
-	return logic_reduce_wrapper(RTLIL::State::S0, logic_or, arg1, result_len);
+	return logic_reduce_wrapper(RTLIL::State::S0, logic_or, logic_or_word, arg1, result_len);
 }
 
 RTLIL::Const RTLIL::const_reduce_xor(const RTLIL::Const &arg1, const RTLIL::Const&, bool, bool, int result_len)
 {
-	return logic_reduce_wrapper(RTLIL::State::S0, logic_xor, arg1, result_len);
+	return logic_reduce_wrapper(RTLIL::State::S0, logic_xor, logic_xor_word, arg1, result_len);
 }
 
 RTLIL::Const RTLIL::const_reduce_xnor(const RTLIL::Const &arg1, const RTLIL::Const&, bool, bool, int result_len)
 {
-	RTLIL::Const buffer = logic_reduce_wrapper(RTLIL::State::S0, logic_xor, arg1, result_len);
+	RTLIL::Const buffer = logic_reduce_wrapper(RTLIL::State::S0, logic_xor, logic_xor_word, arg1, result_len);
 	if (!buffer.bits.empty()) {
 		if (buffer.bits.front() == RTLIL::State::S0)
 			buffer.bits.front() = RTLIL::State::S1;
@@ -233,28 +376,29 @@ RTLIL::Const RTLIL::const_reduce_xnor(const RTLIL::Const &arg1, const RTLIL::Con
 
 RTLIL::Const RTLIL::const_reduce_bool(const RTLIL::Const &arg1, const RTLIL::Const&, bool, bool, int result_len)
 {
-	return logic_reduce_wrapper(RTLIL::State::S0, logic_or, arg1, result_len);
+	return logic_reduce_wrapper(RTLIL::State::S0, logic_or, logic_or_word, arg1, result_len);
+}
+
+// S1 if any bit is set, otherwise Sx if any bit is undefined, otherwise S0
+static RTLIL::State logic_bool(const RTLIL::Const &arg)
+{
+	return logic_reduce_wrapper(RTLIL::State::S0, logic_or, logic_or_word, arg, 1).bits.front();
 }
 
-RTLIL::Const RTLIL::const_logic_not(const RTLIL::Const &arg1, const RTLIL::Const&, bool signed1, bool, int result_len)
+RTLIL::Const RTLIL::const_logic_not(const RTLIL::Const &arg1, const RTLIL::Const&, bool, bool, int result_len)
 {
-	int undef_bit_pos_a = -1;
-	BigInteger a = const2big(arg1, signed1, undef_bit_pos_a);
-	RTLIL::Const result(a.isZero() ? undef_bit_pos_a >= 0 ? RTLIL::State::Sx : RTLIL::State::S1 : RTLIL::State::S0);
+	RTLIL::State bit_a = logic_bool(arg1);
+	RTLIL::Const result(bit_a == RTLIL::State::S0 ? RTLIL::State::S1 : bit_a == RTLIL::State::S1 ? RTLIL::State::S0 : RTLIL::State::Sx);
 
 	while (int(result.bits.size()) < result_len)
 		result.bits.push_back(RTLIL::State::S0);
 	return result;
 }
 
-RTLIL::Const RTLIL::const_logic_and(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
+RTLIL::Const RTLIL::const_logic_and(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool, bool, int result_len)
 {
-	int undef_bit_pos_a = -1, undef_bit_pos_b = -1;
-	BigInteger a = const2big(arg1, signed1, undef_bit_pos_a);
-	BigInteger b = const2big(arg2, signed2, undef_bit_pos_b);
-
-	RTLIL::State bit_a = a.isZero() ? undef_bit_pos_a >= 0 ? RTLIL::State::Sx : RTLIL::State::S0 : RTLIL::State::S1;
-	RTLIL::State bit_b = b.isZero() ? undef_bit_pos_b >= 0 ? RTLIL::State::Sx : RTLIL::State::S0 : RTLIL::State::S1;
+	RTLIL::State bit_a = logic_bool(arg1);
+	RTLIL::State bit_b = logic_bool(arg2);
 	RTLIL::Const result(logic_and(bit_a, bit_b));
 
 	while (int(result.bits.size()) < result_len)
@@ -262,14 +406,10 @@ RTLIL::Const RTLIL::const_logic_and(const RTLIL::Const &arg1, const RTLIL::Const
 	return result;
 }
 
-RTLIL::Const RTLIL::const_logic_or(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
+RTLIL::Const RTLIL::const_logic_or(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool, bool, int result_len)
 {
-	int undef_bit_pos_a = -1, undef_bit_pos_b = -1;
-	BigInteger a = const2big(arg1, signed1, undef_bit_pos_a);
-	BigInteger b = const2big(arg2, signed2, undef_bit_pos_b);
-
-	RTLIL::State bit_a = a.isZero() ? undef_bit_pos_a >= 0 ? RTLIL::State::Sx : RTLIL::State::S0 : RTLIL::State::S1;
-	RTLIL::State bit_b = b.isZero() ? undef_bit_pos_b >= 0 ? RTLIL::State::Sx : RTLIL::State::S0 : RTLIL::State::S1;
+	RTLIL::State bit_a = logic_bool(arg1);
+	RTLIL::State bit_b = logic_bool(arg2);
 	RTLIL::Const result(logic_or(bit_a, bit_b));
 
 	while (int(result.bits.size()) < result_len)
@@ -279,12 +419,29 @@ RTLIL::Const RTLIL::const_logic_or(const RTLIL::Const &arg1, const RTLIL::Const
 
 static RTLIL::Const const_shift(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool sign_ext, int direction, int result_len)
 {
-	int undef_bit_pos = -1;
-	BigInteger offset = const2big(arg2, false, undef_bit_pos) * direction;
-
 	if (result_len < 0)
 		result_len = arg1.bits.size();
 
+	fast_int_t fast_offset;
+	if (const2fast(arg2, false, fast_offset))
+	{
+		RTLIL::Const result(RTLIL::State::Sx, result_len);
+		fast_int_t offset = fast_offset * direction;
+		for (int i = 0; i < result_len; i++) {
+			fast_int_t pos = offset + i;
+			if (pos < 0)
+				result.bits[i] = RTLIL::State::S0;
+			else if (pos >= fast_int_t(arg1.bits.size()))
+				result.bits[i] = sign_ext ? arg1.bits.back() : RTLIL::State::S0;
+			else
+				result.bits[i] = arg1.bits[int(pos)];
+		}
+		return result;
+	}
+
+	int undef_bit_pos = -1;
+	BigInteger offset = const2big(arg2, false, undef_bit_pos) * direction;
+
 	RTLIL::Const result(RTLIL::State::Sx, result_len);
 	if (undef_bit_pos >= 0)
 		return result;
@@ -333,7 +490,9 @@ RTLIL::Const RTLIL::const_sshr(const RTLIL::Const &arg1, const RTLIL::Const &arg
 RTLIL::Const RTLIL::const_lt(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
 	int undef_bit_pos = -1;
-	bool y = const2big(arg1, signed1, undef_bit_pos) < const2big(arg2, signed2, undef_bit_pos);
+	fast_int_t fast_a, fast_b;
+	bool y = const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b) ? fast_a < fast_b :
+			const2big(arg1, signed1, undef_bit_pos) < const2big(arg2, signed2, undef_bit_pos);
 	RTLIL::Const result(undef_bit_pos >= 0 ? RTLIL::State::Sx : y ? RTLIL::State::S1 : RTLIL::State::S0);
 
 	while (int(result.bits.size()) < result_len)
@@ -344,7 +503,9 @@ RTLIL::Const RTLIL::const_lt(const RTLIL::Const &arg1, const RTLIL::Const &arg2,
 RTLIL::Const RTLIL::const_le(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
 	int undef_bit_pos = -1;
-	bool y = const2big(arg1, signed1, undef_bit_pos) <= const2big(arg2, signed2, undef_bit_pos);
+	fast_int_t fast_a, fast_b;
+	bool y = const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b) ? fast_a <= fast_b :
+			const2big(arg1, signed1, undef_bit_pos) <= const2big(arg2, signed2, undef_bit_pos);
 	RTLIL::Const result(undef_bit_pos >= 0 ? RTLIL::State::Sx : y ? RTLIL::State::S1 : RTLIL::State::S0);
 
 	while (int(result.bits.size()) < result_len)
@@ -363,7 +524,15 @@ RTLIL::Const RTLIL::const_eq(const RTLIL::Const &arg1, const RTLIL::Const &arg2,
 	extend_u0(arg2_ext, width, signed1 && signed2);
 
 	RTLIL::State matched_status = RTLIL::State::S1;
-	for (size_t i = 0; i < arg1_ext.bits.size(); i++) {
+	size_t i = 0;
+	for (; i+8 <= arg1_ext.bits.size(); i += 8) {
+		uint64_t a = load_word(&arg1_ext.bits[i]), b = load_word(&arg2_ext.bits[i]);
+		if (((is_s0(a) & is_s1(b)) | (is_s1(a) & is_s0(b))) != 0)
+			return result;
+		if (~((is_s0(a) | is_s1(a)) & (is_s0(b) | is_s1(b))) != 0)
+			matched_status = RTLIL::State::Sx;
+	}
+	for (; i < arg1_ext.bits.size(); i++) {
 		if (arg1_ext.bits.at(i) == RTLIL::State::S0 && arg2_ext.bits.at(i) == RTLIL::State::S1)
 			return result;
 		if (arg1_ext.bits.at(i) == RTLIL::State::S1 && arg2_ext.bits.at(i) == RTLIL::State::S0)
@@ -396,10 +565,8 @@ RTLIL::Const RTLIL::const_eqx(const RTLIL::Const &arg1, const RTLIL::Const &arg2
 	extend_u0(arg1_ext, width, signed1 && signed2);
 	extend_u0(arg2_ext, width, signed1 && signed2);
 
-	for (size_t i = 0; i < arg1_ext.bits.size(); i++) {
-		if (arg1_ext.bits.at(i) != arg2_ext.bits.at(i))
-			return result;
-	}
+	if (arg1_ext.bits != arg2_ext.bits)
+		return result;
 
 	result.bits.front() = RTLIL::State::S1;
 	return result;
@@ -418,7 +585,9 @@ RTLIL::Const RTLIL::const_nex(const RTLIL::Const &arg1, const RTLIL::Const &arg2
 RTLIL::Const RTLIL::const_ge(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
 	int undef_bit_pos = -1;
-	bool y = const2big(arg1, signed1, undef_bit_pos) >= const2big(arg2, signed2, undef_bit_pos);
+	fast_int_t fast_a, fast_b;
+	bool y = const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b) ? fast_a >= fast_b :
+			const2big(arg1, signed1, undef_bit_pos) >= const2big(arg2, signed2, undef_bit_pos);
 	RTLIL::Const result(undef_bit_pos >= 0 ? RTLIL::State::Sx : y ? RTLIL::State::S1 : RTLIL::State::S0);
 
 	while (int(result.bits.size()) < result_len)
@@ -429,7 +598,9 @@ RTLIL::Const RTLIL::const_ge(const RTLIL::Const &arg1, const RTLIL::Const &arg2,
 RTLIL::Const RTLIL::const_gt(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
 	int undef_bit_pos = -1;
-	bool y = const2big(arg1, signed1, undef_bit_pos) > const2big(arg2, signed2, undef_bit_pos);
+	fast_int_t fast_a, fast_b;
+	bool y = const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b) ? fast_a > fast_b :
+			const2big(arg1, signed1, undef_bit_pos) > const2big(arg2, signed2, undef_bit_pos);
 	RTLIL::Const result(undef_bit_pos >= 0 ? RTLIL::State::Sx : y ? RTLIL::State::S1 : RTLIL::State::S0);
 
 	while (int(result.bits.size()) < result_len)
@@ -439,6 +610,10 @@ RTLIL::Const RTLIL::const_gt(const RTLIL::Const &arg1, const RTLIL::Const &arg2,
 
 RTLIL::Const RTLIL::const_add(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
+	fast_int_t fast_a, fast_b;
+	if (const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b))
+		return fast2const(fast_a + fast_b, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()));
+
 	int undef_bit_pos = -1;
 	BigInteger y = const2big(arg1, signed1, undef_bit_pos) + const2big(arg2, signed2, undef_bit_pos);
 	return big2const(y, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()), undef_bit_pos);
@@ -446,6 +621,10 @@ RTLIL::Const RTLIL::const_add(const RTLIL::Const &arg1, const RTLIL::Const &arg2
 
 RTLIL::Const RTLIL::const_sub(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
+	fast_int_t fast_a, fast_b;
+	if (const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b))
+		return fast2const(fast_a - fast_b, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()));
+
 	int undef_bit_pos = -1;
 	BigInteger y = const2big(arg1, signed1, undef_bit_pos) - const2big(arg2, signed2, undef_bit_pos);
 	return big2const(y, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()), undef_bit_pos);
@@ -453,6 +632,10 @@ RTLIL::Const RTLIL::const_sub(const RTLIL::Const &arg1, const RTLIL::Const &arg2
 
 RTLIL::Const RTLIL::const_mul(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
+	fast_int_t fast_a, fast_b;
+	if (const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b))
+		return fast2const(fast_a * fast_b, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()));
+
 	int undef_bit_pos = -1;
 	BigInteger y = const2big(arg1, signed1, undef_bit_pos) * const2big(arg2, signed2, undef_bit_pos);
 	return big2const(y, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()), std::min(undef_bit_pos, 0));
@@ -460,6 +643,15 @@ RTLIL::Const RTLIL::const_mul(const RTLIL::Const &arg1, const RTLIL::Const &arg2
 
 RTLIL::Const RTLIL::const_div(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
+	fast_int_t fast_a, fast_b;
+	if (const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b)) {
+		if (fast_b == 0)
+			return RTLIL::Const(RTLIL::State::Sx, result_len);
+		// native division truncates towards zero and the remainder has the sign
+		// of the dividend, exactly like the BigInteger implementation below
+		return fast2const(fast_a / fast_b, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()));
+	}
+
 	int undef_bit_pos = -1;
 	BigInteger a = const2big(arg1, signed1, undef_bit_pos);
 	BigInteger b = const2big(arg2, signed2, undef_bit_pos);
@@ -473,6 +665,15 @@ RTLIL::Const RTLIL::const_div(const RTLIL::Const &arg1, const RTLIL::Const &arg2
 
 RTLIL::Const RTLIL::const_mod(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
+	fast_int_t fast_a, fast_b;
+	if (const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b)) {
+		if (fast_b == 0)
+			return RTLIL::Const(RTLIL::State::Sx, result_len);
+		// native division truncates towards zero and the remainder has the sign
+		// of the dividend, exactly like the BigInteger implementation below
+		return fast2const(fast_a % fast_b, result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size()));
+	}
+
 	int undef_bit_pos = -1;
 	BigInteger a = const2big(arg1, signed1, undef_bit_pos);
 	BigInteger b = const2big(arg2, signed2, undef_bit_pos);
@@ -486,6 +687,22 @@ RTLIL::Const RTLIL::const_mod(const RTLIL::Const &arg1, const RTLIL::Const &arg2
 
 RTLIL::Const RTLIL::const_pow(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
+	int fast_result_len = result_len >= 0 ? result_len : std::max(arg1.bits.size(), arg2.bits.size());
+	fast_int_t fast_a, fast_b;
+
+	if (fast_result_len <= int(8*sizeof(fast_int_t)) && const2fast(arg1, signed1, fast_a) && const2fast(arg2, signed2, fast_b) && fast_b >= 0)
+	{
+		// power-modulo with 2^(bits in fast_int_t) as modulus, the unsigned
+		// arithmetic wraps around so the lower fast_result_len bits are exact
+		fast_uint_t y = 1, a = fast_a;
+		for (fast_int_t b = fast_b; b > 0; b = b / 2) {
+			if (b % 2 == 1)
+				y = y * a;
+			a = a * a;
+		}
+		return fast2const(fast_int_t(y), fast_result_len);
+	}
+
 	int undef_bit_pos = -1;
 
 	BigInteger a = const2big(arg1, signed1, undef_bit_pos);
@@ -29,7 +29,144 @@
 
 struct CellTypes
 {
-	std::set<std::string> cell_types;
+	// Every cell type name that CellTypes knows about is assigned a small
+	// integer ID in a global registry (see type_id()). The registry entry holds
+	// the list of output ports and the constant evaluation function for the
+	// type, so cell_known(), cell_output() and eval() are table lookups instead
+	// of chains of string comparisons. A CellTypes object itself only stores
+	// one flag per type ID.
+
+	typedef RTLIL::Const (*eval_func_t)(const RTLIL::Const&, const RTLIL::Const&, bool, bool, int);
+
+	enum eval_kind_t {
+		EVAL_NONE,
+		EVAL_FUNC,
+		EVAL_SLICE,
+		EVAL_CONCAT,
+		EVAL_MUX
+	};
+
+	struct type_info_t {
+		RTLIL::IdString type;
+		std::vector<RTLIL::IdString> outputs;
+		eval_kind_t eval_kind;
+		eval_func_t eval_func;
+		// do not reset the signedness flags when only one of the inputs is signed
+		bool eval_keep_signed;
+	};
+
+	struct registry_t
+	{
+		// types[0] is a placeholder for unknown types
+		std::vector<type_info_t> types;
+		// IdString::index_ -> type ID (0 for unregistered names). The IdString
+		// in types[] holds a reference, so an index can not be reused for a
+		// different name while it is in this table.
+		std::vector<int> id_by_name;
+
+		int insert(const RTLIL::IdString &type, eval_kind_t eval_kind = EVAL_NONE, eval_func_t eval_func = NULL, bool eval_keep_signed = false)
+		{
+			int id = lookup(type);
+			if (id != 0)
+				return id;
+			id = types.size();
+			types.push_back(type_info_t());
+			types.back().type = type;
+			types.back().outputs.push_back("\\Y");
+			types.back().outputs.push_back("\\Q");
+			types.back().outputs.push_back("\\RD_DATA");
+			types.back().eval_kind = eval_kind;
+			types.back().eval_func = eval_func;
+			types.back().eval_keep_signed = eval_keep_signed;
+			if (int(id_by_name.size()) <= type.index_)
+				id_by_name.resize(type.index_ + 1);
+			id_by_name[type.index_] = id;
+			return id;
+		}
+
+		int lookup(const RTLIL::IdString &type) const {
+			return type.index_ < int(id_by_name.size()) ? id_by_name[type.index_] : 0;
+		}
+
+		registry_t()
+		{
+			types.push_back(type_info_t());
+			types.back().eval_kind = EVAL_NONE;
+			types.back().eval_func = NULL;
+			types.back().eval_keep_signed = false;
+
+#define REGISTER_CELL_TYPE(_t, _keep_signed) insert("$" #_t, EVAL_FUNC, RTLIL::const_ ## _t, _keep_signed);
+			REGISTER_CELL_TYPE(not, true)
+			REGISTER_CELL_TYPE(and, false)
+			REGISTER_CELL_TYPE(or, false)
+			REGISTER_CELL_TYPE(xor, false)
+			REGISTER_CELL_TYPE(xnor, false)
+			REGISTER_CELL_TYPE(reduce_and, false)
+			REGISTER_CELL_TYPE(reduce_or, false)
+			REGISTER_CELL_TYPE(reduce_xor, false)
+			REGISTER_CELL_TYPE(reduce_xnor, false)
+			REGISTER_CELL_TYPE(reduce_bool, false)
+			REGISTER_CELL_TYPE(logic_not, false)
+			REGISTER_CELL_TYPE(logic_and, false)
+			REGISTER_CELL_TYPE(logic_or, false)
+			REGISTER_CELL_TYPE(shl, true)
+			REGISTER_CELL_TYPE(shr, true)
+			REGISTER_CELL_TYPE(sshl, true)
+			REGISTER_CELL_TYPE(sshr, true)
+			REGISTER_CELL_TYPE(lt, false)
+			REGISTER_CELL_TYPE(le, false)
+			REGISTER_CELL_TYPE(eq, false)
+			REGISTER_CELL_TYPE(ne, false)
+			REGISTER_CELL_TYPE(eqx, false)
+			REGISTER_CELL_TYPE(nex, false)
+			REGISTER_CELL_TYPE(ge, false)
+			REGISTER_CELL_TYPE(gt, false)
+			REGISTER_CELL_TYPE(add, false)
+			REGISTER_CELL_TYPE(sub, false)
+			REGISTER_CELL_TYPE(mul, false)
+			REGISTER_CELL_TYPE(div, false)
+			REGISTER_CELL_TYPE(mod, false)
+			REGISTER_CELL_TYPE(pow, false)
+			REGISTER_CELL_TYPE(pos, true)
+			REGISTER_CELL_TYPE(bu0, true)
+			REGISTER_CELL_TYPE(neg, true)
+#undef REGISTER_CELL_TYPE
+
+			insert("$_INV_", EVAL_FUNC, eval_gate_inv);
+			insert("$_AND_", EVAL_FUNC, eval_gate_and);
+			insert("$_OR_", EVAL_FUNC, eval_gate_or);
+			insert("$_XOR_", EVAL_FUNC, eval_gate_xor);
+
+			insert("$slice", EVAL_SLICE);
+			insert("$concat", EVAL_CONCAT);
+
+			insert("$mux", EVAL_MUX);
+			insert("$pmux", EVAL_MUX);
+			insert("$safe_pmux", EVAL_MUX);
+			insert("$_MUX_", EVAL_MUX);
+
+			types[insert("$memrd")].outputs.push_back("\\DATA");
+			types[insert("$fsm")].outputs.push_back("\\CTRL_OUT");
+			types[insert("$lut")].outputs.push_back("\\O");
+		}
+	};
+
+	// allocated on first use and never freed (like the IdString storage)
+	static registry_t &registry() {
+		static registry_t *reg = new registry_t;
+		return *reg;
+	}
+
+	static int type_id(const RTLIL::IdString &type) {
+		return registry().lookup(type);
+	}
+
+	static const type_info_t &type_info(const RTLIL::IdString &type) {
+		registry_t &reg = registry();
+		return reg.types[reg.lookup(type)];
+	}
+
+	std::vector<bool> known_types;
 	std::vector<const RTLIL::Design*> designs;
 
 	CellTypes()
@@ -56,119 +193,139 @@ struct CellTypes
 		designs.push_back(design);
 	}
 
+	void setup_type(const RTLIL::IdString &type)
+	{
+		int id = registry().insert(type);
+		if (int(known_types.size()) <= id)
+			known_types.resize(id + 1);
+		known_types[id] = true;
+	}
+
+	void erase_type(const RTLIL::IdString &type)
+	{
+		int id = type_id(type);
+		if (id < int(known_types.size()))
+			known_types[id] = false;
+	}
+
 	void setup_internals()
 	{
-		cell_types.insert("$not");
-		cell_types.insert("$pos");
-		cell_types.insert("$bu0");
-		cell_types.insert("$neg");
-		cell_types.insert("$and");
-		cell_types.insert("$or");
-		cell_types.insert("$xor");
-		cell_types.insert("$xnor");
-		cell_types.insert("$reduce_and");
-		cell_types.insert("$reduce_or");
-		cell_types.insert("$reduce_xor");
-		cell_types.insert("$reduce_xnor");
-		cell_types.insert("$reduce_bool");
-		cell_types.insert("$shl");
-		cell_types.insert("$shr");
-		cell_types.insert("$sshl");
-		cell_types.insert("$sshr");
-		cell_types.insert("$lt");
-		cell_types.insert("$le");
-		cell_types.insert("$eq");
-		cell_types.insert("$ne");
-		cell_types.insert("$eqx");
-		cell_types.insert("$nex");
-		cell_types.insert("$ge");
-		cell_types.insert("$gt");
-		cell_types.insert("$add");
-		cell_types.insert("$sub");
-		cell_types.insert("$mul");
-		cell_types.insert("$div");
-		cell_types.insert("$mod");
-		cell_types.insert("$pow");
-		cell_types.insert("$logic_not");
-		cell_types.insert("$logic_and");
-		cell_types.insert("$logic_or");
-		cell_types.insert("$mux");
-		cell_types.insert("$pmux");
-		cell_types.insert("$slice");
-		cell_types.insert("$concat");
-		cell_types.insert("$safe_pmux");
-		cell_types.insert("$lut");
-		cell_types.insert("$assert");
+		setup_type("$not");
+		setup_type("$pos");
+		setup_type("$bu0");
+		setup_type("$neg");
+		setup_type("$and");
+		setup_type("$or");
+		setup_type("$xor");
+		setup_type("$xnor");
+		setup_type("$reduce_and");
+		setup_type("$reduce_or");
+		setup_type("$reduce_xor");
+		setup_type("$reduce_xnor");
+		setup_type("$reduce_bool");
+		setup_type("$shl");
+		setup_type("$shr");
+		setup_type("$sshl");
+		setup_type("$sshr");
+		setup_type("$lt");
+		setup_type("$le");
+		setup_type("$eq");
+		setup_type("$ne");
+		setup_type("$eqx");
+		setup_type("$nex");
+		setup_type("$ge");
+		setup_type("$gt");
+		setup_type("$add");
+		setup_type("$sub");
+		setup_type("$mul");
+		setup_type("$div");
+		setup_type("$mod");
+		setup_type("$pow");
+		setup_type("$logic_not");
+		setup_type("$logic_and");
+		setup_type("$logic_or");
+		setup_type("$mux");
+		setup_type("$pmux");
+		setup_type("$slice");
+		setup_type("$concat");
+		setup_type("$safe_pmux");
+		setup_type("$lut");
+		setup_type("$assert");
 	}
 
 	void setup_internals_mem()
 	{
-		cell_types.insert("$sr");
-		cell_types.insert("$dff");
-		cell_types.insert("$dffsr");
-		cell_types.insert("$adff");
-		cell_types.insert("$dlatch");
-		cell_types.insert("$dlatchsr");
-		cell_types.insert("$memrd");
-		cell_types.insert("$memwr");
-		cell_types.insert("$mem");
-		cell_types.insert("$fsm");
+		setup_type("$sr");
+		setup_type("$dff");
+		setup_type("$dffsr");
+		setup_type("$adff");
+		setup_type("$dlatch");
+		setup_type("$dlatchsr");
+		setup_type("$memrd");
+		setup_type("$memwr");
+		setup_type("$mem");
+		setup_type("$fsm");
 	}
 
 	void setup_stdcells()
 	{
-		cell_types.insert("$_INV_");
-		cell_types.insert("$_AND_");
-		cell_types.insert("$_OR_");
-		cell_types.insert("$_XOR_");
-		cell_types.insert("$_MUX_");
+		setup_type("$_INV_");
+		setup_type("$_AND_");
+		setup_type("$_OR_");
+		setup_type("$_XOR_");
+		setup_type("$_MUX_");
 	}
 
 	void setup_stdcells_mem()
 	{
-		cell_types.insert("$_SR_NN_");
-		cell_types.insert("$_SR_NP_");
-		cell_types.insert("$_SR_PN_");
-		cell_types.insert("$_SR_PP_");
-		cell_types.insert("$_DFF_N_");
-		cell_types.insert("$_DFF_P_");
-		cell_types.insert("$_DFF_NN0_");
-		cell_types.insert("$_DFF_NN1_");
-		cell_types.insert("$_DFF_NP0_");
-		cell_types.insert("$_DFF_NP1_");
-		cell_types.insert("$_DFF_PN0_");
-		cell_types.insert("$_DFF_PN1_");
-		cell_types.insert("$_DFF_PP0_");
-		cell_types.insert("$_DFF_PP1_");
-		cell_types.insert("$_DFFSR_NNN_");
-		cell_types.insert("$_DFFSR_NNP_");
-		cell_types.insert("$_DFFSR_NPN_");
-		cell_types.insert("$_DFFSR_NPP_");
-		cell_types.insert("$_DFFSR_PNN_");
-		cell_types.insert("$_DFFSR_PNP_");
-		cell_types.insert("$_DFFSR_PPN_");
-		cell_types.insert("$_DFFSR_PPP_");
-		cell_types.insert("$_DLATCH_N_");
-		cell_types.insert("$_DLATCH_P_");
-		cell_types.insert("$_DLATCHSR_NNN_");
-		cell_types.insert("$_DLATCHSR_NNP_");
-		cell_types.insert("$_DLATCHSR_NPN_");
-		cell_types.insert("$_DLATCHSR_NPP_");
-		cell_types.insert("$_DLATCHSR_PNN_");
-		cell_types.insert("$_DLATCHSR_PNP_");
-		cell_types.insert("$_DLATCHSR_PPN_");
-		cell_types.insert("$_DLATCHSR_PPP_");
+		setup_type("$_SR_NN_");
+		setup_type("$_SR_NP_");
+		setup_type("$_SR_PN_");
+		setup_type("$_SR_PP_");
+		setup_type("$_DFF_N_");
+		setup_type("$_DFF_P_");
+		setup_type("$_DFF_NN0_");
+		setup_type("$_DFF_NN1_");
+		setup_type("$_DFF_NP0_");
+		setup_type("$_DFF_NP1_");
+		setup_type("$_DFF_PN0_");
+		setup_type("$_DFF_PN1_");
+		setup_type("$_DFF_PP0_");
+		setup_type("$_DFF_PP1_");
+		setup_type("$_DFFSR_NNN_");
+		setup_type("$_DFFSR_NNP_");
+		setup_type("$_DFFSR_NPN_");
+		setup_type("$_DFFSR_NPP_");
+		setup_type("$_DFFSR_PNN_");
+		setup_type("$_DFFSR_PNP_");
+		setup_type("$_DFFSR_PPN_");
+		setup_type("$_DFFSR_PPP_");
+		setup_type("$_DLATCH_N_");
+		setup_type("$_DLATCH_P_");
+		setup_type("$_DLATCHSR_NNN_");
+		setup_type("$_DLATCHSR_NNP_");
+		setup_type("$_DLATCHSR_NPN_");
+		setup_type("$_DLATCHSR_NPP_");
+		setup_type("$_DLATCHSR_PNN_");
+		setup_type("$_DLATCHSR_PNP_");
+		setup_type("$_DLATCHSR_PPN_");
+		setup_type("$_DLATCHSR_PPP_");
 	}
 
 	void clear()
 	{
-		cell_types.clear();
+		known_types.clear();
 		designs.clear();
 	}
 
-	bool cell_known(std::string type)
+	bool builtin_known(int id) const
 	{
-		if (cell_types.count(type) > 0)
+		return id != 0 && id < int(known_types.size()) && known_types[id];
+	}
+
+	bool cell_known(const RTLIL::IdString &type)
+	{
+		if (builtin_known(type_id(type)))
 			return true;
 		for (auto design : designs)
 			if (design->modules.count(type) > 0)
@@ -176,9 +333,11 @@ struct CellTypes
 		return false;
 	}
 
-	bool cell_output(std::string type, std::string port)
+	bool cell_output(const RTLIL::IdString &type, const RTLIL::IdString &port)
 	{
-		if (cell_types.count(type) == 0) {
+		int id = type_id(type);
+
+		if (!builtin_known(id)) {
 			for (auto design : designs)
 				if (design->modules.count(type) > 0) {
 					if (design->modules.at(type)->wires.count(port))
@@ -188,20 +347,17 @@ struct CellTypes
 			return false;
 		}
 
-		if (port == "\\Y" || port == "\\Q" || port == "\\RD_DATA")
-			return true;
-		if (type == "$memrd" && port == "\\DATA")
-			return true;
-		if (type == "$fsm" && port == "\\CTRL_OUT")
-			return true;
-		if (type == "$lut" && port == "\\O")
-			return true;
+		for (auto &p : registry().types[id].outputs)
+			if (p == port)
+				return true;
 		return false;
 	}
 
-	bool cell_input(std::string type, std::string port)
+	bool cell_input(const RTLIL::IdString &type, const RTLIL::IdString &port)
 	{
-		if (cell_types.count(type) == 0) {
+		int id = type_id(type);
+
+		if (!builtin_known(id)) {
 			for (auto design : designs)
 				if (design->modules.count(type) > 0) {
 					if (design->modules.at(type)->wires.count(port))
@@ -211,77 +367,49 @@ struct CellTypes
 			return false;
 		}
 
-		if (cell_types.count(type) > 0)
-			return !cell_output(type, port);
+		for (auto &p : registry().types[id].outputs)
+			if (p == port)
+				return false;
+		return true;
+	}
+
+	static RTLIL::Const eval_gate_inv(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool, bool, int) {
+		return RTLIL::const_not(arg1, arg2, false, false, 1);
+	}
 
-		return false;
+	static RTLIL::Const eval_gate_and(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool, bool, int) {
+		return RTLIL::const_and(arg1, arg2, false, false, 1);
+	}
+
+	static RTLIL::Const eval_gate_or(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool, bool, int) {
+		return RTLIL::const_or(arg1, arg2, false, false, 1);
+	}
+
+	static RTLIL::Const eval_gate_xor(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool, bool, int) {
+		return RTLIL::const_xor(arg1, arg2, false, false, 1);
 	}
 
-	static RTLIL::Const eval(std::string type, const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
+	static RTLIL::Const eval(const type_info_t &info, const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 	{
-		if (type == "$sshr" && !signed1)
-			type = "$shr";
-		if (type == "$sshl" && !signed1)
-			type = "$shl";
-
-		if (type != "$sshr" && type != "$sshl" && type != "$shr" && type != "$shl" &&
-				type != "$pos" && type != "$neg" && type != "$not" && type != "$bu0") {
-			if (!signed1 || !signed2)
-				signed1 = false, signed2 = false;
-		}
+		if (info.eval_kind != EVAL_FUNC)
+			log_abort();
+
+		if (!info.eval_keep_signed && (!signed1 || !signed2))
+			signed1 = false, signed2 = false;
+
+		return info.eval_func(arg1, arg2, signed1, signed2, result_len);
+	}
 
-#define HANDLE_CELL_TYPE(_t) if (type == "$" #_t) return const_ ## _t(arg1, arg2, signed1, signed2, result_len);
-		HANDLE_CELL_TYPE(not)
-		HANDLE_CELL_TYPE(and)
-		HANDLE_CELL_TYPE(or)
-		HANDLE_CELL_TYPE(xor)
-		HANDLE_CELL_TYPE(xnor)
-		HANDLE_CELL_TYPE(reduce_and)
-		HANDLE_CELL_TYPE(reduce_or)
-		HANDLE_CELL_TYPE(reduce_xor)
-		HANDLE_CELL_TYPE(reduce_xnor)
-		HANDLE_CELL_TYPE(reduce_bool)
-		HANDLE_CELL_TYPE(logic_not)
-		HANDLE_CELL_TYPE(logic_and)
-		HANDLE_CELL_TYPE(logic_or)
-		HANDLE_CELL_TYPE(shl)
-		HANDLE_CELL_TYPE(shr)
-		HANDLE_CELL_TYPE(sshl)
-		HANDLE_CELL_TYPE(sshr)
-		HANDLE_CELL_TYPE(lt)
-		HANDLE_CELL_TYPE(le)
-		HANDLE_CELL_TYPE(eq)
-		HANDLE_CELL_TYPE(ne)
-		HANDLE_CELL_TYPE(eqx)
-		HANDLE_CELL_TYPE(nex)
-		HANDLE_CELL_TYPE(ge)
-		HANDLE_CELL_TYPE(gt)
-		HANDLE_CELL_TYPE(add)
-		HANDLE_CELL_TYPE(sub)
-		HANDLE_CELL_TYPE(mul)
-		HANDLE_CELL_TYPE(div)
-		HANDLE_CELL_TYPE(mod)
-		HANDLE_CELL_TYPE(pow)
-		HANDLE_CELL_TYPE(pos)
-		HANDLE_CELL_TYPE(bu0)
-		HANDLE_CELL_TYPE(neg)
-#undef HANDLE_CELL_TYPE
-
-		if (type == "$_INV_")
-			return const_not(arg1, arg2, false, false, 1);
-		if (type == "$_AND_")
-			return const_and(arg1, arg2, false, false, 1);
-		if (type == "$_OR_")
-			return const_or(arg1, arg2, false, false, 1);
-		if (type == "$_XOR_")
-			return const_xor(arg1, arg2, false, false, 1);
-
-		log_abort();
+	static RTLIL::Const eval(const RTLIL::IdString &type, const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
+	{
+		return eval(type_info(type), arg1, arg2, signed1, signed2, result_len);
 	}
 
 	static RTLIL::Const eval(RTLIL::Cell *cell, const RTLIL::Const &arg1, const RTLIL::Const &arg2)
 	{
-		if (cell->type == "$slice") {
+		const type_info_t &info = type_info(cell->type);
+
+		if (info.eval_kind == EVAL_SLICE) {
 			RTLIL::Const ret;
 			int width = cell->parameters.at("\\Y_WIDTH").as_int();
 			int offset = cell->parameters.at("\\OFFSET").as_int();
@@ -289,7 +417,7 @@ struct CellTypes
 			return ret;
 		}
 
-		if (cell->type == "$concat") {
+		if (info.eval_kind == EVAL_CONCAT) {
 			RTLIL::Const ret = arg1;
 			ret.bits.insert(ret.bits.end(), arg2.bits.begin(), arg2.bits.end());
 			return ret;
@@ -298,12 +426,12 @@ struct CellTypes
 		bool signed_a = cell->parameters.count("\\A_SIGNED") > 0 && cell->parameters["\\A_SIGNED"].as_bool();
 		bool signed_b = cell->parameters.count("\\B_SIGNED") > 0 && cell->parameters["\\B_SIGNED"].as_bool();
 		int result_len = cell->parameters.count("\\Y_WIDTH") > 0 ? cell->parameters["\\Y_WIDTH"].as_int() : -1;
-		return eval(cell->type, arg1, arg2, signed_a, signed_b, result_len);
+		return eval(info, arg1, arg2, signed_a, signed_b, result_len);
 	}
 
 	static RTLIL::Const eval(RTLIL::Cell *cell, const RTLIL::Const &arg1, const RTLIL::Const &arg2, const RTLIL::Const &sel)
 	{
-		if (cell->type == "$mux" || cell->type == "$pmux" || cell->type == "$safe_pmux" || cell->type == "$_MUX_") {
+		if (type_info(cell->type).eval_kind == EVAL_MUX) {
 			RTLIL::Const ret = arg1;
 			for (size_t i = 0; i < sel.bits.size(); i++)
 				if (sel.bits[i] == RTLIL::State::S1) {
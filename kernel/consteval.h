@@ -23,30 +23,27 @@
 #include "kernel/rtlil.h"
 #include "kernel/sigtools.h"
 #include "kernel/celltypes.h"
+#include "kernel/modindex.h"
+
+// ConstEval uses the index owned by the module (see kernel/modindex.h) to find
+// the driver of a signal. The index must not be invalidated while the ConstEval
+// object is in use.
 
 struct ConstEval
 {
 	RTLIL::Module *module;
-	SigMap assign_map;
+	ModIndex *index;
+	SigMap &assign_map;
 	SigMap values_map;
 	SigPool stop_signals;
-	SigSet<RTLIL::Cell*> sig2driver;
+	CellTypes ct;
 	std::set<RTLIL::Cell*> busy;
 	std::vector<SigMap> stack;
 
-	ConstEval(RTLIL::Module *module) : module(module), assign_map(module)
+	ConstEval(RTLIL::Module *module) : module(module), index(module->index()), assign_map(index->sigmap)
 	{
-		CellTypes ct;
 		ct.setup_internals();
 		ct.setup_stdcells();
-
-		for (auto &it : module->cells) {
-			if (!ct.cell_known(it.second->type))
-				continue;
-			for (auto &it2 : it.second->connections)
-				if (ct.cell_output(it.second->type, it2.first))
-					sig2driver.insert(assign_map(it2.second), it.second);
-		}
 	}
 
 	void clear()
@@ -71,11 +68,8 @@ struct ConstEval
 		assign_map.apply(sig);
 #ifndef NDEBUG
 		RTLIL::SigSpec current_val = values_map(sig);
-		current_val.expand();
-		for (size_t i = 0; i < current_val.chunks.size(); i++) {
-			RTLIL::SigChunk &chunk = current_val.chunks[i];
-			assert(chunk.wire != NULL || chunk.data.bits[0] == value.bits[i]);
-		}
+		for (int i = 0; i < current_val.width; i++)
+			assert(current_val[i].wire != NULL || current_val[i].data == value.bits[i]);
 #endif
 		values_map.add(sig, RTLIL::SigSpec(value));
 	}
@@ -194,7 +188,9 @@ struct ConstEval
 		}
 
 		std::set<RTLIL::Cell*> driver_cells;
-		sig2driver.find(sig, driver_cells);
+		for (auto cell : index->query_drivers(sig))
+			if (ct.cell_known(cell->type))
+				driver_cells.insert(cell);
 		for (auto cell : driver_cells) {
 			if (!eval(cell, undef)) {
 				if (busy_cell)
@@ -210,9 +206,9 @@ struct ConstEval
 		if (sig.is_fully_const())
 			return true;
 
-		for (size_t i = 0; i < sig.chunks.size(); i++)
-			if (sig.chunks[i].wire != NULL)
-				undef.append(sig.chunks[i]);
+		for (auto &c : sig.chunks())
+			if (c.wire != NULL)
+				undef.append(c);
 		return false;
 	}
 
@@ -490,7 +490,7 @@ int main(int argc, char **argv)
 	}
 
 	int opt;
-	while ((opt = getopt(argc, argv, "VSm:f:Hh:b:o:p:l:qv:ts:c:")) != -1)
+	while ((opt = getopt(argc, argv, "VSm:f:Hh:b:o:p:l:qv:ts:c:j:")) != -1)
 	{
 		switch (opt)
 		{
@@ -557,9 +557,16 @@ int main(int argc, char **argv)
 			scriptfile = optarg;
 			scriptfile_tcl = true;
 			break;
+		case 'j':
+			yosys_threads = atoi(optarg);
+			if (yosys_threads < 1) {
+				fprintf(stderr, "Invalid number of threads `%s'!\n", optarg);
+				exit(1);
+			}
+			break;
 		default:
 			fprintf(stderr, "\n");
-			fprintf(stderr, "Usage: %s [-V] [-S] [-q] [-v <level>[-t] [-l <logfile>] [-o <outfile>] [-f <frontend>] [-h cmd] \\\n", argv[0]);
+			fprintf(stderr, "Usage: %s [-V] [-S] [-q] [-v <level>[-t] [-j <threads>] [-l <logfile>] [-o <outfile>] [-f <frontend>] [-h cmd] \\\n", argv[0]);
 			fprintf(stderr, "       %*s[{-s|-c} <scriptfile>] [-p <pass> [-p ..]] [-b <backend>] [-m <module_file>] [<infile> [..]]\n", int(strlen(argv[0])+1), "");
 			fprintf(stderr, "\n");
 			fprintf(stderr, "    -q\n");
@@ -571,6 +578,12 @@ int main(int argc, char **argv)
 			fprintf(stderr, "    -t\n");
 			fprintf(stderr, "        annotate all log messages with a time stamp\n");
 			fprintf(stderr, "\n");
+			fprintf(stderr, "    -j threads\n");
+			fprintf(stderr, "        process independent modules in up to this many threads in passes\n");
+			fprintf(stderr, "        that support it (opt_clean, opt_const, proc_*). the log output and\n");
+			fprintf(stderr, "        results do not depend on the scheduling of the threads, but the names\n");
+			fprintf(stderr, "        of auto-generated wires and cells are numbered per module\n");
+			fprintf(stderr, "\n");
 			fprintf(stderr, "    -l logfile\n");
 			fprintf(stderr, "        write log messages to the specified file\n");
 			fprintf(stderr, "\n");
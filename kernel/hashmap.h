@@ -0,0 +1,409 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <stdint.h>
+#include <vector>
+#include <new>
+
+// HashMap is a replacement for std::map with insertion-ordered iteration.
+//
+// The entries are stored in a sequence of blocks with doubling sizes (4, 8,
+// 16, ..), so that inserting new entries never moves existing ones: pointers
+// and references to elements stay valid as they do with std::map. Erased
+// entries are left behind as dead slots until more than half of the slots
+// are dead, then erase() compacts the storage. So (unlike std::map) erasing
+// elements while iterating over the map is only safe using the iterator
+// returned by erase().
+//
+// Small maps (up to 8 entries, e.g. cell connections and parameters) are
+// searched linearly. Larger maps use an open addressing hash table (linear
+// probing, storing entry indices) that is only allocated when needed.
+//
+// Iteration visits the elements in the order they were inserted. A range-based
+// for loop does not visit elements inserted while the loop is running.
+
+template<typename K, typename T, typename OPS = std::hash<K>>
+class HashMap
+{
+public:
+	typedef std::pair<K, T> value_type;
+
+private:
+	static const int small_size = 8;
+	static const int first_block_size = 4;
+
+	struct entry_t {
+		value_type udata;
+		unsigned int hash;
+		bool alive;
+		entry_t(const value_type &udata, unsigned int hash) : udata(udata), hash(hash), alive(true) { }
+	};
+
+	std::vector<entry_t*> blocks;
+	std::vector<int> hashtable;
+	int entries_n, alive_n;
+
+	static void locate(int index, int &block, int &offset) {
+		unsigned int k = (index / first_block_size) + 1;
+		block = 31 - __builtin_clz(k);
+		offset = index - first_block_size * ((1 << block) - 1);
+	}
+
+	entry_t &entry(int index) const {
+		int block, offset;
+		locate(index, block, offset);
+		return blocks[block][offset];
+	}
+
+	// std::hash is the identity function for integers and pointers,
+	// so mix the bits before using the lower bits as table index
+	static unsigned int do_hash(const K &key) {
+		uint64_t h = OPS()(key);
+		return (h * 0x9e3779b97f4a7c15ULL) >> 32;
+	}
+
+	void do_rehash(int min_size)
+	{
+		int size = 16;
+		while (size < 2*min_size)
+			size *= 2;
+		hashtable.clear();
+		hashtable.resize(size, -1);
+		int mask = size - 1;
+		for (int i = 0; i < entries_n; i++) {
+			entry_t &e = entry(i);
+			if (!e.alive)
+				continue;
+			int slot = e.hash & mask;
+			while (hashtable[slot] >= 0)
+				slot = (slot + 1) & mask;
+			hashtable[slot] = i;
+		}
+	}
+
+	// drop the dead entries, returns the new index of the entry at old_index
+	// (or of the first live entry after it)
+	int do_compact(int old_index)
+	{
+		std::vector<entry_t*> old_blocks;
+		int old_entries_n = entries_n;
+		int new_index = -1;
+		old_blocks.swap(blocks);
+		entries_n = 0;
+		alive_n = 0;
+		for (int i = 0; i < old_entries_n; i++) {
+			int block, offset;
+			locate(i, block, offset);
+			entry_t &e = old_blocks[block][offset];
+			if (i == old_index)
+				new_index = entries_n;
+			if (e.alive)
+				do_append(e.udata, e.hash);
+			e.~entry_t();
+		}
+		for (auto b : old_blocks)
+			::operator delete(b);
+		hashtable.clear();
+		if (alive_n > small_size)
+			do_rehash(alive_n);
+		return new_index < 0 ? entries_n : new_index;
+	}
+
+	int do_append(const value_type &value, unsigned int hash)
+	{
+		int block, offset;
+		locate(entries_n, block, offset);
+		if (block == int(blocks.size()))
+			blocks.push_back(static_cast<entry_t*>(::operator new(sizeof(entry_t) * (first_block_size << block))));
+		new (&blocks[block][offset]) entry_t(value, hash);
+		alive_n++;
+		return entries_n++;
+	}
+
+	int do_lookup(const K &key, unsigned int hash) const
+	{
+		if (hashtable.empty()) {
+			for (int i = 0; i < entries_n; i++) {
+				const entry_t &e = entry(i);
+				if (e.alive && e.hash == hash && e.udata.first == key)
+					return i;
+			}
+			return -1;
+		}
+
+		int mask = hashtable.size() - 1;
+		for (int slot = hash & mask; hashtable[slot] >= 0; slot = (slot + 1) & mask) {
+			const entry_t &e = entry(hashtable[slot]);
+			if (e.hash == hash && e.udata.first == key)
+				return hashtable[slot];
+		}
+		return -1;
+	}
+
+	int do_insert(const value_type &value, unsigned int hash)
+	{
+		int index = do_append(value, hash);
+
+		if (hashtable.empty()) {
+			if (alive_n > small_size)
+				do_rehash(alive_n);
+		} else if (2*alive_n > int(hashtable.size())) {
+			do_rehash(alive_n);
+		} else {
+			int mask = hashtable.size() - 1;
+			int slot = hash & mask;
+			while (hashtable[slot] >= 0)
+				slot = (slot + 1) & mask;
+			hashtable[slot] = index;
+		}
+
+		return index;
+	}
+
+	// returns the index of the next live entry
+	int do_erase(int index)
+	{
+		entry_t &e = entry(index);
+
+		if (!hashtable.empty()) {
+			int mask = hashtable.size() - 1;
+			int slot = e.hash & mask;
+			while (hashtable[slot] != index)
+				slot = (slot + 1) & mask;
+			// backward shift deletion
+			for (int next = (slot + 1) & mask; hashtable[next] >= 0; next = (next + 1) & mask) {
+				int home = entry(hashtable[next]).hash & mask;
+				if (((next - home) & mask) >= ((next - slot) & mask)) {
+					hashtable[slot] = hashtable[next];
+					slot = next;
+				}
+			}
+			hashtable[slot] = -1;
+		}
+
+		e.udata = value_type();
+		e.alive = false;
+		alive_n--;
+
+		if (entries_n - alive_n > alive_n && entries_n - alive_n > small_size)
+			return do_compact(index+1);
+		return next_alive(index+1);
+	}
+
+	int next_alive(int index) const {
+		while (index < entries_n && !entry(index).alive)
+			index++;
+		return index;
+	}
+
+public:
+	template<bool is_const>
+	class iterator_base : public std::iterator<std::forward_iterator_tag, value_type>
+	{
+		friend class HashMap;
+		template<bool> friend class iterator_base;
+		typedef typename std::conditional<is_const, const HashMap, HashMap>::type map_type;
+		typedef typename std::conditional<is_const, const value_type, value_type>::type ref_type;
+		map_type *ptr;
+		int index;
+		iterator_base(map_type *ptr, int index) : ptr(ptr), index(index) { }
+	public:
+		iterator_base() : ptr(NULL), index(0) { }
+		template<bool other_const>
+		iterator_base(const iterator_base<other_const> &other) : ptr(other.ptr), index(other.index) { }
+		iterator_base &operator++() { index = ptr->next_alive(index+1); return *this; }
+		iterator_base operator++(int) { iterator_base tmp = *this; ++*this; return tmp; }
+		bool operator==(const iterator_base &other) const { return index == other.index; }
+		bool operator!=(const iterator_base &other) const { return index != other.index; }
+		ref_type &operator*() const { return ptr->entry(index).udata; }
+		ref_type *operator->() const { return &ptr->entry(index).udata; }
+	};
+
+	typedef iterator_base<false> iterator;
+	typedef iterator_base<true> const_iterator;
+
+	HashMap() : entries_n(0), alive_n(0) { }
+
+	HashMap(const HashMap &other) : entries_n(0), alive_n(0) {
+		*this = other;
+	}
+
+	HashMap(HashMap &&other) : entries_n(0), alive_n(0) {
+		swap(other);
+	}
+
+	~HashMap() {
+		clear();
+	}
+
+	HashMap &operator=(const HashMap &other) {
+		if (this != &other) {
+			clear();
+			for (int i = 0; i < other.entries_n; i++) {
+				const entry_t &e = other.entry(i);
+				if (e.alive)
+					do_insert(e.udata, e.hash);
+			}
+		}
+		return *this;
+	}
+
+	HashMap &operator=(HashMap &&other) {
+		clear();
+		swap(other);
+		return *this;
+	}
+
+	void swap(HashMap &other) {
+		blocks.swap(other.blocks);
+		hashtable.swap(other.hashtable);
+		std::swap(entries_n, other.entries_n);
+		std::swap(alive_n, other.alive_n);
+	}
+
+	void clear() {
+		for (int i = 0; i < entries_n; i++)
+			entry(i).~entry_t();
+		for (auto b : blocks)
+			::operator delete(b);
+		blocks.clear();
+		hashtable.clear();
+		entries_n = 0;
+		alive_n = 0;
+	}
+
+	size_t size() const { return alive_n; }
+	bool empty() const { return alive_n == 0; }
+
+	iterator begin() { return iterator(this, next_alive(0)); }
+	iterator end() { return iterator(this, entries_n); }
+	const_iterator begin() const { return const_iterator(this, next_alive(0)); }
+	const_iterator end() const { return const_iterator(this, entries_n); }
+
+	size_t count(const K &key) const {
+		return do_lookup(key, do_hash(key)) < 0 ? 0 : 1;
+	}
+
+	iterator find(const K &key) {
+		int index = do_lookup(key, do_hash(key));
+		return index < 0 ? end() : iterator(this, index);
+	}
+
+	const_iterator find(const K &key) const {
+		int index = do_lookup(key, do_hash(key));
+		return index < 0 ? end() : const_iterator(this, index);
+	}
+
+	T &at(const K &key) {
+		int index = do_lookup(key, do_hash(key));
+		if (index < 0)
+			throw std::out_of_range("HashMap::at()");
+		return entry(index).udata.second;
+	}
+
+	const T &at(const K &key) const {
+		int index = do_lookup(key, do_hash(key));
+		if (index < 0)
+			throw std::out_of_range("HashMap::at()");
+		return entry(index).udata.second;
+	}
+
+	T &operator[](const K &key) {
+		unsigned int hash = do_hash(key);
+		int index = do_lookup(key, hash);
+		if (index < 0)
+			index = do_insert(value_type(key, T()), hash);
+		return entry(index).udata.second;
+	}
+
+	std::pair<iterator, bool> insert(const value_type &value) {
+		unsigned int hash = do_hash(value.first);
+		int index = do_lookup(value.first, hash);
+		if (index >= 0)
+			return std::pair<iterator, bool>(iterator(this, index), false);
+		index = do_insert(value, hash);
+		return std::pair<iterator, bool>(iterator(this, index), true);
+	}
+
+	size_t erase(const K &key) {
+		int index = do_lookup(key, do_hash(key));
+		if (index < 0)
+			return 0;
+		do_erase(index);
+		return 1;
+	}
+
+	iterator erase(iterator it) {
+		return iterator(this, do_erase(it.index));
+	}
+
+	// re-insert all elements sorted by key (for deterministic, name-sorted output)
+	void sort() {
+		std::vector<value_type> values;
+		values.reserve(alive_n);
+		for (auto &it : *this)
+			values.push_back(it);
+		std::sort(values.begin(), values.end(), [](const value_type &a, const value_type &b) { return a.first < b.first; });
+		clear();
+		for (auto &it : values)
+			do_insert(it, do_hash(it.first));
+	}
+
+	// equality does not depend on the insertion order
+	bool operator==(const HashMap &other) const {
+		if (alive_n != other.alive_n)
+			return false;
+		for (int i = 0; i < entries_n; i++) {
+			const entry_t &e = entry(i);
+			if (!e.alive)
+				continue;
+			int index = other.do_lookup(e.udata.first, e.hash);
+			if (index < 0 || !(other.entry(index).udata.second == e.udata.second))
+				return false;
+		}
+		return true;
+	}
+
+	bool operator!=(const HashMap &other) const {
+		return !(*this == other);
+	}
+
+	// compares the key-sorted contents, like std::map does
+	bool operator<(const HashMap &other) const {
+		std::vector<const value_type*> lhs, rhs;
+		for (auto &it : *this)
+			lhs.push_back(&it);
+		for (auto &it : other)
+			rhs.push_back(&it);
+		auto key_less = [](const value_type *a, const value_type *b) { return a->first < b->first; };
+		std::sort(lhs.begin(), lhs.end(), key_less);
+		std::sort(rhs.begin(), rhs.end(), key_less);
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+				[](const value_type *a, const value_type *b) { return *a < *b; });
+	}
+};
+
+#endif
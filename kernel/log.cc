@@ -36,7 +36,14 @@ bool log_cmd_error_throw = false;
 int log_verbose_level;
 
 std::vector<int> header_count;
-std::list<std::string> string_buf;
+
+// per thread, so that log_signal() does not need a lock. log_pop() releases
+// the strings of the main thread, log_capture_end() those of a work unit.
+static thread_local std::list<std::string> string_buf;
+static thread_local size_t string_buf_mark;
+
+// log output of the current work unit of a worker thread, or NULL
+static thread_local std::string *log_capture = NULL;
 
 static struct timeval initial_tv = { 0, 0 };
 static bool next_print_log = false;
@@ -62,6 +69,18 @@ std::string stringf(const char *fmt, ...)
 
 void logv(const char *format, va_list ap)
 {
+	if (log_files.empty())
+		return;
+
+	if (log_capture != NULL) {
+		char *str = NULL;
+		if (vasprintf(&str, format, ap) >= 0) {
+			log_capture->append(str);
+			free(str);
+		}
+		return;
+	}
+
 	if (log_time) {
 		while (format[0] == '\n' && format[1] != 0) {
 			format++;
@@ -121,6 +140,8 @@ void logv_error(const char *format, va_list ap)
 		fprintf(log_errfile, "ERROR: ");
 		vfprintf(log_errfile, format, ap);
 	}
+	if (log_capture != NULL)
+		throw log_worker_error();
 	log_flush();
 	exit(1);
 }
@@ -183,6 +204,30 @@ void log_reset_stack()
 	log_flush();
 }
 
+void log_capture_begin(std::string *buffer)
+{
+	log_capture = buffer;
+	string_buf_mark = string_buf.size();
+}
+
+void log_capture_end()
+{
+	log_capture = NULL;
+	while (string_buf.size() > string_buf_mark)
+		string_buf.pop_back();
+}
+
+void log_capture_flush(const std::string &buffer)
+{
+	// write line by line so that "yosys -t" adds its timestamps
+	for (size_t pos = 0; pos < buffer.size();) {
+		size_t end = buffer.find('\n', pos);
+		end = end == std::string::npos ? buffer.size() : end + 1;
+		log("%s", buffer.substr(pos, end - pos).c_str());
+		pos = end;
+	}
+}
+
 void log_flush()
 {
 	for (auto f : log_files)
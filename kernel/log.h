@@ -33,6 +33,20 @@ extern bool log_time;
 extern bool log_cmd_error_throw;
 extern int log_verbose_level;
 
+// Logging from parallel code (see Pass::run_modules()): a worker thread
+// brackets each unit of work with log_capture_begin() and log_capture_end().
+// In between, the log output of the thread is appended to the buffer instead
+// of being written, log_signal() strings of the unit are released at the end,
+// and log_error() throws log_worker_error instead of exiting. The main thread
+// then writes the buffers with log_capture_flush() in a fixed order (e.g. the
+// order of the modules), so that the log does not depend on the scheduling of
+// the threads. log_header(), log_push() and log_pop() must not be called from
+// a worker thread.
+void log_capture_begin(std::string *buffer);
+void log_capture_end();
+void log_capture_flush(const std::string &buffer);
+struct log_worker_error { };
+
 std::string stringf(const char *fmt, ...);
 
 void logv(const char *format, va_list ap);
@@ -0,0 +1,239 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *  
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef MODINDEX_H
+#define MODINDEX_H
+
+#include "kernel/rtlil.h"
+#include "kernel/sigtools.h"
+#include "kernel/celltypes.h"
+#include <algorithm>
+#include <set>
+
+// ModIndex maps each canonical (SigMap-ed) bit of a module to the cell ports
+// driving and reading it. Use RTLIL::Module::index() to get the index owned
+// by a module: it is kept up to date by Module::add(), Module::remove() and
+// Module::connect() and dropped by Pass::call() after each pass that does not
+// set Pass::preserves_index. Ports of cells of unknown type are listed both
+// as drivers and readers.
+
+struct ModIndex
+{
+	struct PortInfo {
+		RTLIL::Cell *cell;
+		RTLIL::IdString port;
+		int offset;
+
+		PortInfo(RTLIL::Cell *cell, RTLIL::IdString port, int offset) : cell(cell), port(port), offset(offset) { }
+
+		bool operator<(const PortInfo &other) const {
+			if (cell != other.cell)
+				return cell < other.cell;
+			if (port != other.port)
+				return port.index_ < other.port.index_;
+			return offset < other.offset;
+		}
+
+		bool operator==(const PortInfo &other) const {
+			return cell == other.cell && port == other.port && offset == other.offset;
+		}
+	};
+
+	struct BitInfo {
+		bool is_input, is_output;
+		std::vector<PortInfo> drivers, readers;
+		BitInfo() : is_input(false), is_output(false) { }
+	};
+
+	struct hash_sigbit {
+		size_t operator()(const RTLIL::SigBit &bit) const {
+			return bit.wire ? size_t(bit.wire) + bit.offset : size_t(bit.data);
+		}
+	};
+
+	RTLIL::Module *module;
+	CellTypes ct;
+	SigMap sigmap;
+	HashMap<RTLIL::SigBit, BitInfo, hash_sigbit> database;
+	HashMap<RTLIL::IdString, HashMap<RTLIL::IdString, int>> port_dir_cache;
+
+	ModIndex(RTLIL::Module *module) : module(module), sigmap(module)
+	{
+		ct.setup_internals();
+		ct.setup_internals_mem();
+		ct.setup_stdcells();
+		ct.setup_stdcells_mem();
+
+		for (auto &it : module->wires)
+			add_wire(it.second);
+		for (auto &it : module->cells)
+			add_cell(it.second);
+	}
+
+	// internal helper function
+	static void remove_port(std::vector<PortInfo> &ports, const PortInfo &port)
+	{
+		ports.erase(std::remove(ports.begin(), ports.end(), port), ports.end());
+	}
+
+	// internal helper function
+	int port_dir(RTLIL::Cell *cell, RTLIL::IdString port)
+	{
+		// 1 = output, 0 = input, -1 = unknown (cached by cell type)
+		HashMap<RTLIL::IdString, int> &ports = port_dir_cache[cell->type];
+		auto it = ports.find(port);
+		if (it != ports.end())
+			return it->second;
+		int dir = !ct.cell_known(cell->type) ? -1 : ct.cell_output(cell->type, port) ? 1 : 0;
+		ports[port] = dir;
+		return dir;
+	}
+
+	// internal helper function
+	void port_bits(RTLIL::Cell *cell, RTLIL::IdString port, const RTLIL::SigSpec &sig, bool remove)
+	{
+		int dir = port_dir(cell, port);
+		bool is_output = dir != 0, is_input = dir != 1;
+
+		int i = 0;
+		for (auto &c : sig.chunks())
+		for (int j = 0; j < c.width; j++, i++)
+		{
+			if (c.wire == NULL)
+				continue;
+
+			RTLIL::SigBit bit = sigmap.map_bit(RTLIL::SigBit(c.wire, c.offset + j));
+			PortInfo pi(cell, port, i);
+
+			if (remove) {
+				auto it = database.find(bit);
+				if (it == database.end())
+					continue;
+				if (is_output)
+					remove_port(it->second.drivers, pi);
+				if (is_input)
+					remove_port(it->second.readers, pi);
+			} else {
+				BitInfo &info = database[bit];
+				if (is_output)
+					info.drivers.push_back(pi);
+				if (is_input)
+					info.readers.push_back(pi);
+			}
+		}
+	}
+
+	void add_wire(RTLIL::Wire *wire)
+	{
+		if (!wire->port_input && !wire->port_output)
+			return;
+		for (int i = 0; i < wire->width; i++) {
+			BitInfo &info = database[sigmap.map_bit(RTLIL::SigBit(wire, i))];
+			info.is_input |= wire->port_input;
+			info.is_output |= wire->port_output;
+		}
+	}
+
+	void add_cell(RTLIL::Cell *cell)
+	{
+		for (auto &conn : cell->connections)
+			port_bits(cell, conn.first, conn.second, false);
+	}
+
+	void remove_cell(RTLIL::Cell *cell)
+	{
+		for (auto &conn : cell->connections)
+			port_bits(cell, conn.first, conn.second, true);
+	}
+
+	// internal helper function
+	void move_bit(const RTLIL::SigBit &from, const RTLIL::SigBit &to)
+	{
+		if (from == to)
+			return;
+
+		auto it = database.find(from);
+		if (it == database.end())
+			return;
+
+		BitInfo &info = database[to];
+		info.is_input |= it->second.is_input;
+		info.is_output |= it->second.is_output;
+		info.drivers.insert(info.drivers.end(), it->second.drivers.begin(), it->second.drivers.end());
+		info.readers.insert(info.readers.end(), it->second.readers.begin(), it->second.readers.end());
+		database.erase(from);
+	}
+
+	void connect(const RTLIL::SigSig &conn)
+	{
+		std::vector<RTLIL::SigBit> lhs = conn.first.to_sigbit_vector();
+		std::vector<RTLIL::SigBit> rhs = conn.second.to_sigbit_vector();
+		assert(lhs.size() == rhs.size());
+
+		std::vector<RTLIL::SigBit> old_lhs(lhs.size()), old_rhs(rhs.size());
+		for (size_t i = 0; i < lhs.size(); i++) {
+			old_lhs[i] = sigmap.map_bit(lhs[i]);
+			old_rhs[i] = sigmap.map_bit(rhs[i]);
+		}
+
+		sigmap.add(conn.first, conn.second);
+
+		for (size_t i = 0; i < lhs.size(); i++) {
+			if (lhs[i].wire == NULL)
+				continue;
+			RTLIL::SigBit new_bit = sigmap.map_bit(lhs[i]);
+			move_bit(old_lhs[i], new_bit);
+			move_bit(old_rhs[i], new_bit);
+		}
+	}
+
+	BitInfo *query(const RTLIL::SigBit &bit)
+	{
+		auto it = database.find(sigmap.map_bit(bit));
+		if (it == database.end())
+			return NULL;
+		return &it->second;
+	}
+
+	std::set<RTLIL::Cell*> query_drivers(const RTLIL::SigSpec &sig)
+	{
+		std::set<RTLIL::Cell*> cells;
+		for (auto &bit : sig.to_sigbit_vector()) {
+			BitInfo *info = query(bit);
+			if (info != NULL)
+				for (auto &pi : info->drivers)
+					cells.insert(pi.cell);
+		}
+		return cells;
+	}
+
+	std::set<RTLIL::Cell*> query_readers(const RTLIL::SigSpec &sig)
+	{
+		std::set<RTLIL::Cell*> cells;
+		for (auto &bit : sig.to_sigbit_vector()) {
+			BitInfo *info = query(bit);
+			if (info != NULL)
+				for (auto &pi : info->readers)
+					cells.insert(pi.cell);
+		}
+		return cells;
+	}
+};
+
+#endif /* MODINDEX_H */
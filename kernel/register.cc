@@ -20,11 +20,15 @@
 #include "kernel/compatibility.h"
 #include "kernel/register.h"
 #include "kernel/log.h"
+#include "kernel/celltypes.h"
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <thread>
+#include <atomic>
+#include <exception>
 
 using namespace REGISTER_INTERN;
 #define MAX_REG_COUNT 1000
@@ -43,7 +47,9 @@ namespace REGISTER_INTERN
 
 std::vector<std::string> Frontend::next_args;
 
-Pass::Pass(std::string name, std::string short_help) : pass_name(name), short_help(short_help)
+int yosys_threads = 1;
+
+Pass::Pass(std::string name, std::string short_help) : pass_name(name), short_help(short_help), preserves_index(false), read_only(false), tracks_changes(false), selection_touched(false)
 {
 	assert(!raw_register_done);
 	assert(raw_register_count < MAX_REG_COUNT);
@@ -128,6 +134,18 @@ void Pass::extra_args(std::vector<std::string> args, size_t argidx, RTLIL::Desig
 		break;
 	}
 	// cmd_log_args(args);
+
+	if (select && !read_only) {
+		design->unshare_modules(true);
+		if (!tracks_changes && !preserves_index) {
+			for (auto &it : design->modules)
+				if (design->selected_module(it.first)) {
+					it.second->touch();
+					touched_modules.push_back(it.first);
+				}
+			selection_touched = true;
+		}
+	}
 }
 
 void Pass::call(RTLIL::Design *design, std::string command)
@@ -175,6 +193,112 @@ void Pass::call(RTLIL::Design *design, std::string command)
 	call(design, args);
 }
 
+bool Pass::at_fixpoint(RTLIL::Design *design, RTLIL::Module *module, std::string mode)
+{
+	if (!design->selected_whole_module(module->name))
+		return false;
+	auto it = fixpoint_generation.find(std::pair<std::string, RTLIL::IdString>(mode, module->name));
+	return it != fixpoint_generation.end() && it->second == module->generation;
+}
+
+void Pass::module_done(RTLIL::Design *design, RTLIL::Module *module, bool changed, std::string mode)
+{
+	std::pair<std::string, RTLIL::IdString> key(mode, module->name);
+	if (changed)
+		module->touch();
+	if (changed || !design->selected_whole_module(module->name))
+		fixpoint_generation.erase(key);
+	else
+		fixpoint_generation[key] = module->generation;
+}
+
+void Pass::run_modules(const std::vector<RTLIL::Module*> &modules, std::function<void(int)> worker)
+{
+	int num_jobs = modules.size();
+	int num_threads = std::min(yosys_threads, num_jobs);
+
+	if (num_threads <= 1) {
+		for (int i = 0; i < num_jobs; i++)
+			worker(i);
+		return;
+	}
+
+	std::vector<std::string> job_log(num_jobs);
+	std::vector<int> job_autoidx(num_jobs, RTLIL::autoidx);
+	std::vector<std::exception_ptr> job_error(num_jobs);
+	std::atomic<int> next_job(0);
+	std::atomic<bool> failed(false);
+
+	// the lazily created cell type registry must exist before the threads
+	// start, the workers only look up types in it
+	CellTypes::registry();
+
+	// jobs are started in index order and no new jobs are started after an
+	// error, so all jobs before the first failing one have been completed
+	auto thread_main = [&]() {
+		while (!failed) {
+			int i = next_job++;
+			if (i >= num_jobs)
+				break;
+			log_capture_begin(&job_log[i]);
+			RTLIL::job_autoidx = &job_autoidx[i];
+			try {
+				worker(i);
+			} catch (...) {
+				job_error[i] = std::current_exception();
+				failed = true;
+			}
+			log_capture_end();
+			RTLIL::job_autoidx = NULL;
+		}
+	};
+
+	RTLIL::multi_threaded = true;
+	std::vector<std::thread> threads;
+	for (int i = 1; i < num_threads; i++)
+		threads.push_back(std::thread(thread_main));
+	thread_main();
+	for (auto &thread : threads)
+		thread.join();
+	RTLIL::multi_threaded = false;
+
+	for (int i = 0; i < num_jobs; i++)
+	{
+		log_capture_flush(job_log[i]);
+		RTLIL::autoidx = std::max(RTLIL::autoidx.load(), job_autoidx[i]);
+
+		if (job_error[i]) {
+			try {
+				std::rethrow_exception(job_error[i]);
+			} catch (log_worker_error) {
+				log_flush();
+				exit(1);
+			}
+		}
+	}
+}
+
+static void invalidate_indexes(RTLIL::Design *design)
+{
+	for (auto &it : design->modules)
+		it.second->invalidate_index();
+}
+
+// touch the modules selected in extra_args() again after the pass (it might
+// have called other passes that recorded a fixpoint in the meantime), or all
+// modules if the pass did not call extra_args() with select=true
+static void touch_modules(RTLIL::Design *design, Pass *pass)
+{
+	if (pass->selection_touched) {
+		for (auto &name : pass->touched_modules)
+			if (design->modules.count(name))
+				design->modules.at(name)->touch();
+	} else {
+		for (auto &it : design->modules)
+			it.second->touch();
+	}
+}
+
 void Pass::call(RTLIL::Design *design, std::vector<std::string> args)
 {
 	if (args.size() == 0 || args[0][0] == '#')
@@ -190,8 +314,34 @@ void Pass::call(RTLIL::Design *design, std::vector<std::string> args)
 	if (pass_register.count(args[0]) == 0)
 		log_cmd_error("No such command: %s (type 'help' for a command overview)\n", args[0].c_str());
 
+	Pass *pass = pass_register[args[0]];
+	if (!pass->preserves_index)
+		invalidate_indexes(design);
+
+	bool touch_after = !pass->preserves_index && !pass->read_only && !pass->tracks_changes;
+	bool orig_selection_touched = pass->selection_touched;
+	std::vector<RTLIL::IdString> orig_touched_modules;
+	orig_touched_modules.swap(pass->touched_modules);
+	pass->selection_touched = false;
+
 	size_t orig_sel_stack_pos = design->selection_stack.size();
-	pass_register[args[0]]->execute(args, design);
+	try {
+		pass->execute(args, design);
+	} catch (...) {
+		if (!pass->preserves_index)
+			invalidate_indexes(design);
+		if (touch_after)
+			touch_modules(design, pass);
+		pass->selection_touched = orig_selection_touched;
+		pass->touched_modules.swap(orig_touched_modules);
+		throw;
+	}
+	if (!pass->preserves_index)
+		invalidate_indexes(design);
+	if (touch_after)
+		touch_modules(design, pass);
+	pass->selection_touched = orig_selection_touched;
+	pass->touched_modules.swap(orig_touched_modules);
 	while (design->selection_stack.size() > orig_sel_stack_pos)
 		design->selection_stack.pop_back();
 
@@ -318,6 +468,7 @@ void Frontend::frontend_call(RTLIL::Design *design, FILE *f, std::string filenam
 
 Backend::Backend(std::string name, std::string short_help) : Pass("write_"+name, short_help), backend_name(name)
 {
+	read_only = true;
 }
 
 void Backend::run_register()
@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
 
 #ifdef YOSYS_ENABLE_TCL
 #include <tcl.h>
@@ -40,6 +41,9 @@ extern std::string proc_self_dirname();
 extern std::string proc_share_dirname();
 const char *create_prompt(RTLIL::Design *design, int recursion_counter);
 
+// maximum number of threads used by Pass::run_modules() (yosys -j)
+extern int yosys_threads;
+
 // from passes/cmds/design.cc
 extern std::map<std::string, RTLIL::Design*> saved_designs;
 extern std::vector<RTLIL::Design*> pushed_designs;
@@ -47,6 +51,45 @@ extern std::vector<RTLIL::Design*> pushed_designs;
 struct Pass
 {
 	std::string pass_name, short_help;
+
+	// set by passes that modify modules only through the RTLIL::Module API
+	// (or not at all), so that the module indexes survive the pass
+	bool preserves_index;
+
+	// set by passes that never modify the modules of the design, so that
+	// extra_args() does not unshare modules shared with design snapshots
+	bool read_only;
+
+	// set by passes that call RTLIL::Module::touch() for every module they
+	// modify. Other passes (that do not set preserves_index or read_only) are
+	// assumed to modify all modules selected in extra_args(), or all modules
+	// of the design if they do not call extra_args() with select=true.
+	bool tracks_changes;
+	bool selection_touched;
+	std::vector<RTLIL::IdString> touched_modules;
+
+	// A module-local pass that tracks changes can skip a module when
+	// at_fixpoint() returns true, i.e. when the module has not been modified
+	// since this pass (with the same mode string) last ran on it without
+	// changing it. The pass reports each processed module to module_done().
+	std::map<std::pair<std::string, RTLIL::IdString>, uint64_t> fixpoint_generation;
+	bool at_fixpoint(RTLIL::Design *design, RTLIL::Module *module, std::string mode = std::string());
+	void module_done(RTLIL::Design *design, RTLIL::Module *module, bool changed, std::string mode = std::string());
+
+	// Module-local work: a pass that processes each module on its own (only
+	// reading and modifying that module, and not calling other passes or
+	// log_header()) collects the modules it wants to process and hands the
+	// work for one module to run_modules(), which calls worker(i) for each
+	// index i into modules. With yosys_threads > 1 the calls are distributed
+	// over a pool of threads. The log output of each call is buffered and
+	// written in the order of the modules vector, and new_id() numbers the
+	// new names per module starting at the same value of RTLIL::autoidx, so
+	// the results do not depend on the scheduling of the threads. If a worker
+	// fails, the error of the first failing module in that order is reported.
+	// Everything that is not per-module (at_fixpoint(), module_done(), counters
+	// for the summary) is best done before or after the run_modules() call.
+	void run_modules(const std::vector<RTLIL::Module*> &modules, std::function<void(int)> worker);
+
 	Pass(std::string name, std::string short_help = "** document me **");
 	virtual void run_register();
 	virtual ~Pass();
@@ -20,6 +20,7 @@
 #include "kernel/compatibility.h"
 #include "kernel/rtlil.h"
 #include "kernel/log.h"
+#include "kernel/modindex.h"
 #include "frontends/verilog/verilog_frontend.h"
 #include "backends/ilang/ilang_backend.h"
 
@@ -27,7 +28,165 @@
 #include <string.h>
 #include <algorithm>
 
-int RTLIL::autoidx = 1;
+std::atomic<int> RTLIL::autoidx(1);
+thread_local int *RTLIL::job_autoidx = NULL;
+bool RTLIL::multi_threaded = false;
+
+RTLIL::IdString::storage_t *RTLIL::IdString::global_storage_ = NULL;
+
+RTLIL::IdString::storage_t::storage_t()
+{
+	for (auto &chunk : chunks)
+		chunk = NULL;
+
+	// index 0 is reserved for the empty string
+	chunks[0] = new entry_t[chunk_size];
+	chunks[0][0].str = new std::string;
+	chunks[0][0].refcount = 0;
+	size = 1;
+
+	hashtable.resize(1024, std::pair<unsigned int, int>(0, 0));
+	hashtable_used = 0;
+
+	for (auto &it : lookup_cache)
+		it.first = NULL, it.second = 0;
+}
+
+static unsigned int id_string_hash(const char *p)
+{
+	unsigned int h = 5381;
+	while (*p)
+		h = ((h << 5) + h) ^ (unsigned char)*(p++);
+	return h;
+}
+
+static void id_string_rehash(RTLIL::IdString::storage_t &stor, size_t new_size)
+{
+	std::vector<std::pair<unsigned int, int>> old_hashtable;
+	old_hashtable.swap(stor.hashtable);
+	stor.hashtable.resize(new_size, std::pair<unsigned int, int>(0, 0));
+
+	size_t mask = new_size - 1;
+	for (auto &it : old_hashtable) {
+		if (it.second == 0)
+			continue;
+		size_t slot = it.first & mask;
+		while (stor.hashtable[slot].second != 0)
+			slot = (slot + 1) & mask;
+		stor.hashtable[slot] = it;
+	}
+}
+
+// called with storage_t::mutex locked if RTLIL::multi_threaded is set
+int RTLIL::IdString::get_reference_worker(const char *p)
+{
+	storage_t &stor = *global_storage_;
+	unsigned int hash = id_string_hash(p);
+	size_t mask = stor.hashtable.size() - 1;
+	size_t slot = hash & mask;
+
+	while (stor.hashtable[slot].second != 0) {
+		int idx = stor.hashtable[slot].second;
+		if (stor.hashtable[slot].first == hash && !strcmp(stor.entry(idx).str->c_str(), p)) {
+			get_reference(idx);
+			return idx;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	int idx;
+	if (stor.free_indices.empty()) {
+		idx = stor.size;
+		if (stor.chunks[idx >> chunk_bits] == NULL) {
+			assert((idx >> chunk_bits) < max_chunks);
+			stor.chunks[idx >> chunk_bits] = new entry_t[chunk_size];
+		}
+		stor.size++;
+	} else {
+		idx = stor.free_indices.back();
+		stor.free_indices.pop_back();
+	}
+	stor.entry(idx).str = new std::string(p);
+	stor.entry(idx).refcount = 1;
+
+	stor.hashtable[slot] = std::pair<unsigned int, int>(hash, idx);
+	if (2 * size_t(++stor.hashtable_used) > stor.hashtable.size())
+		id_string_rehash(stor, 2 * stor.hashtable.size());
+
+	return idx;
+}
+
+void RTLIL::IdString::put_reference_worker(int idx)
+{
+	storage_t &stor = *global_storage_;
+	std::unique_lock<std::mutex> lock(stor.mutex, std::defer_lock);
+
+	if (multi_threaded) {
+		// another thread might have found the string in the hash table (or
+		// already released it) since the reference count dropped to zero
+		lock.lock();
+		if (stor.entry(idx).str == NULL || stor.entry(idx).refcount != 0)
+			return;
+	}
+	assert(stor.entry(idx).refcount == 0);
+
+	size_t mask = stor.hashtable.size() - 1;
+	size_t slot = id_string_hash(stor.entry(idx).str->c_str()) & mask;
+	while (stor.hashtable[slot].second != idx)
+		slot = (slot + 1) & mask;
+
+	// backward shift deletion: move entries up into the free slot until we
+	// reach an empty slot or an entry that is already at its home position
+	for (size_t next = (slot + 1) & mask; stor.hashtable[next].second != 0; next = (next + 1) & mask) {
+		size_t home = stor.hashtable[next].first & mask;
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			stor.hashtable[slot] = stor.hashtable[next];
+			slot = next;
+		}
+	}
+	stor.hashtable[slot] = std::pair<unsigned int, int>(0, 0);
+	stor.hashtable_used--;
+
+	delete stor.entry(idx).str;
+	stor.entry(idx).str = NULL;
+	stor.free_indices.push_back(idx);
+}
+
+size_t RTLIL::IdString::pool_size()
+{
+	if (global_storage_ == NULL)
+		return 0;
+	return global_storage_->hashtable_used;
+}
+
+size_t RTLIL::IdString::pool_bytes()
+{
+	if (global_storage_ == NULL)
+		return 0;
+	size_t bytes = 0;
+	for (int idx = 1; idx < global_storage_->size; idx++) {
+		std::string *str = global_storage_->entry(idx).str;
+		if (str != NULL)
+			bytes += sizeof(std::string) + str->capacity() + 1;
+	}
+	return bytes;
+}
+
+RTLIL::NewIdPrefix::NewIdPrefix(const char *file, int line, const char *func)
+{
+	const char *basename = strrchr(file, '/');
+	prefix = stringf("$auto$%s:%d:%s$", basename != NULL ? basename+1 : file, line, func);
+}
+
+RTLIL::IdString RTLIL::NewIdPrefix::next() const
+{
+	char buffer[16];
+	int len = snprintf(buffer, sizeof(buffer), "%d", next_autoidx());
+	std::string str;
+	str.reserve(prefix.size() + len);
+	str.append(prefix).append(buffer, len);
+	return str;
+}
 
 RTLIL::Const::Const()
 {
@@ -66,10 +225,7 @@ bool RTLIL::Const::operator <(const RTLIL::Const &other) const
 {
 	if (bits.size() != other.bits.size())
 		return bits.size() < other.bits.size();
-	for (size_t i = 0; i < bits.size(); i++)
-		if (bits[i] != other.bits[i])
-			return bits[i] < other.bits[i];
-	return false;
+	return !bits.empty() && memcmp(&bits[0], &other.bits[0], bits.size()) < 0;
 }
 
 bool RTLIL::Const::operator ==(const RTLIL::Const &other) const
@@ -102,6 +258,7 @@ int RTLIL::Const::as_int() const
 std::string RTLIL::Const::as_string() const
 {
 	std::string ret;
+	ret.reserve(bits.size());
 	for (size_t i = bits.size(); i > 0; i--)
 		switch (bits[i-1]) {
 			case S0: ret += "0"; break;
@@ -223,7 +380,40 @@ void RTLIL::Selection::optimize(RTLIL::Design *design)
 RTLIL::Design::~Design()
 {
 	for (auto it = modules.begin(); it != modules.end(); it++)
-		delete it->second;
+		release_module(it->second);
+}
+
+RTLIL::Module *RTLIL::Design::share_module(RTLIL::Module *module)
+{
+	module->share_count++;
+	return module;
+}
+
+void RTLIL::Design::release_module(RTLIL::Module *module)
+{
+	if (module->share_count > 0)
+		module->share_count--;
+	else
+		delete module;
+}
+
+RTLIL::Module *RTLIL::Design::unshare_module(RTLIL::IdString mod_name)
+{
+	RTLIL::Module *&module = modules.at(mod_name);
+	if (module->share_count > 0) {
+		module->share_count--;
+		module = module->clone();
+	}
+	return module;
+}
+
+void RTLIL::Design::unshare_modules(bool only_selected)
+{
+	for (auto &it : modules)
+		if (it.second->share_count > 0 && (!only_selected || selected_module(it.first))) {
+			it.second->share_count--;
+			it.second = it.second->clone();
+		}
 }
 
 void RTLIL::Design::check()
@@ -274,8 +464,18 @@ bool RTLIL::Design::selected_member(RTLIL::IdString mod_name, RTLIL::IdString me
 	return selection_stack.back().selected_member(mod_name, memb_name);
 }
 
+static std::atomic<uint64_t> module_generation_counter(0);
+
+RTLIL::Module::Module()
+{
+	modindex = NULL;
+	share_count = 0;
+	generation = ++module_generation_counter;
+}
+
 RTLIL::Module::~Module()
 {
+	delete modindex;
 	for (auto it = wires.begin(); it != wires.end(); it++)
 		delete it->second;
 	for (auto it = memories.begin(); it != memories.end(); it++)
@@ -286,7 +486,7 @@ RTLIL::Module::~Module()
 		delete it->second;
 }
 
-RTLIL::IdString RTLIL::Module::derive(RTLIL::Design*, std::map<RTLIL::IdString, RTLIL::Const>)
+RTLIL::IdString RTLIL::Module::derive(RTLIL::Design*, HashMap<RTLIL::IdString, RTLIL::Const>)
 {
 	log_error("Module `%s' is used with parameters but is not parametric!\n", id2cstr(name));
 }
@@ -799,9 +999,11 @@ void RTLIL::Module::cloneInto(RTLIL::Module *new_mod) const
 		RTLIL::Module *mod;
 		void operator()(RTLIL::SigSpec &sig)
 		{
-			for (auto &c : sig.chunks)
+			std::vector<RTLIL::SigChunk> chunks = sig.chunks();
+			for (auto &c : chunks)
 				if (c.wire != NULL)
 					c.wire = mod->wires.at(c.wire->name);
+			sig = chunks;
 		}
 	};
 
@@ -831,6 +1033,9 @@ void RTLIL::Module::add(RTLIL::Wire *wire)
 	assert(!wire->name.empty());
 	assert(count_id(wire->name) == 0);
 	wires[wire->name] = wire;
+	if (modindex != NULL)
+		modindex->add_wire(wire);
+	touch();
 }
 
 void RTLIL::Module::add(RTLIL::Cell *cell)
@@ -838,6 +1043,45 @@ void RTLIL::Module::add(RTLIL::Cell *cell)
 	assert(!cell->name.empty());
 	assert(count_id(cell->name) == 0);
 	cells[cell->name] = cell;
+	if (modindex != NULL)
+		modindex->add_cell(cell);
+	touch();
+}
+
+void RTLIL::Module::remove(RTLIL::Cell *cell)
+{
+	assert(cells.count(cell->name) != 0);
+	if (modindex != NULL)
+		modindex->remove_cell(cell);
+	cells.erase(cell->name);
+	delete cell;
+	touch();
+}
+
+void RTLIL::Module::connect(const RTLIL::SigSig &conn)
+{
+	connections.push_back(conn);
+	if (modindex != NULL)
+		modindex->connect(conn);
+	touch();
+}
+
+void RTLIL::Module::touch()
+{
+	generation = ++module_generation_counter;
+}
+
+ModIndex *RTLIL::Module::index()
+{
+	if (modindex == NULL)
+		modindex = new ModIndex(this);
+	return modindex;
+}
+
+void RTLIL::Module::invalidate_index()
+{
+	delete modindex;
+	modindex = NULL;
 }
 
 static bool fixup_ports_compare(const RTLIL::Wire *a, const RTLIL::Wire *b)
@@ -865,6 +1109,9 @@ void RTLIL::Module::fixup_ports()
 	std::sort(all_ports.begin(), all_ports.end(), fixup_ports_compare);
 	for (size_t i = 0; i < all_ports.size(); i++)
 		all_ports[i]->port_id = i+1;
+
+	invalidate_index();
+	touch();
 }
 
 
@@ -1233,6 +1480,137 @@ RTLIL::Cell* RTLIL::Module::addDlatchsrGate(RTLIL::IdString name, RTLIL::SigSpec
 }
 
 
+namespace {
+	// a simple pool allocator for objects of one size: slots are carved from
+	// blocks of pool_block_size objects and freed slots are kept in a free
+	// list. all blocks are released when the last object has been freed.
+	// alloc() and free() lock the pool while RTLIL::multi_threaded is set.
+	const int pool_block_size = 1024;
+
+	struct ObjectPool
+	{
+		struct free_slot_t {
+			free_slot_t *next;
+		};
+
+		size_t slot_size;
+		std::vector<char*> blocks;
+		free_slot_t *free_list;
+		size_t live_objects, peak_objects;
+		std::mutex mutex;
+
+		ObjectPool(size_t object_size, size_t align)
+		{
+			slot_size = std::max(object_size, sizeof(free_slot_t));
+			slot_size = (slot_size + align - 1) / align * align;
+			free_list = NULL;
+			live_objects = 0;
+			peak_objects = 0;
+		}
+
+		void *alloc()
+		{
+			std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+			if (RTLIL::multi_threaded)
+				lock.lock();
+			if (free_list == NULL) {
+				char *block = (char*)malloc(pool_block_size * slot_size);
+				if (block == NULL)
+					throw std::bad_alloc();
+				blocks.push_back(block);
+				for (int i = pool_block_size-1; i >= 0; i--) {
+					free_slot_t *slot = (free_slot_t*)(block + i*slot_size);
+					slot->next = free_list;
+					free_list = slot;
+				}
+			}
+			free_slot_t *slot = free_list;
+			free_list = slot->next;
+			peak_objects = std::max(peak_objects, ++live_objects);
+			return slot;
+		}
+
+		void free(void *ptr)
+		{
+			std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+			if (RTLIL::multi_threaded)
+				lock.lock();
+			free_slot_t *slot = (free_slot_t*)ptr;
+			slot->next = free_list;
+			free_list = slot;
+			if (--live_objects == 0) {
+				for (auto block : blocks)
+					::free(block);
+				blocks.clear();
+				free_list = NULL;
+			}
+		}
+
+		void get_stats(RTLIL::PoolStats &stats, size_t object_size) const
+		{
+			// glibc malloc: 8 bytes of chunk header, 16 byte granularity, 32 bytes minimum
+			size_t malloc_chunk = std::max<size_t>(32, (object_size + 8 + 15) & ~15);
+			stats.slot_size = slot_size;
+			stats.live_objects = live_objects;
+			stats.peak_objects = peak_objects;
+			stats.total_slots = blocks.size() * pool_block_size;
+			stats.block_bytes = blocks.size() * pool_block_size * slot_size;
+			stats.malloc_bytes = live_objects * malloc_chunk;
+		}
+	};
+
+	// never destructed, so objects deleted by static destructors are safe
+	ObjectPool &wire_pool() {
+		static ObjectPool *pool = new ObjectPool(sizeof(RTLIL::Wire), __alignof__(RTLIL::Wire));
+		return *pool;
+	}
+
+	ObjectPool &cell_pool() {
+		static ObjectPool *pool = new ObjectPool(sizeof(RTLIL::Cell), __alignof__(RTLIL::Cell));
+		return *pool;
+	}
+}
+
+void RTLIL::get_pool_stats(RTLIL::PoolStats &wire_stats, RTLIL::PoolStats &cell_stats)
+{
+	wire_pool().get_stats(wire_stats, sizeof(RTLIL::Wire));
+	cell_pool().get_stats(cell_stats, sizeof(RTLIL::Cell));
+}
+
+void *RTLIL::Wire::operator new(size_t size)
+{
+	if (size != sizeof(RTLIL::Wire))
+		return ::operator new(size);
+	return wire_pool().alloc();
+}
+
+void RTLIL::Wire::operator delete(void *ptr, size_t size)
+{
+	if (ptr == NULL)
+		return;
+	if (size != sizeof(RTLIL::Wire))
+		::operator delete(ptr);
+	else
+		wire_pool().free(ptr);
+}
+
+void *RTLIL::Cell::operator new(size_t size)
+{
+	if (size != sizeof(RTLIL::Cell))
+		return ::operator new(size);
+	return cell_pool().alloc();
+}
+
+void RTLIL::Cell::operator delete(void *ptr, size_t size)
+{
+	if (ptr == NULL)
+		return;
+	if (size != sizeof(RTLIL::Cell))
+		::operator delete(ptr);
+	else
+		cell_pool().free(ptr);
+}
+
 RTLIL::Wire::Wire()
 {
 	width = 1;
@@ -1367,93 +1745,145 @@ RTLIL::SigSpec::SigSpec()
 
 RTLIL::SigSpec::SigSpec(const RTLIL::Const &data)
 {
-	chunks.push_back(RTLIL::SigChunk(data));
-	width = chunks.back().width;
+	width = 0;
+	append_chunk(RTLIL::SigChunk(data), 0, data.bits.size());
 	check();
 }
 
 RTLIL::SigSpec::SigSpec(const RTLIL::SigChunk &chunk)
 {
-	chunks.push_back(chunk);
-	width = chunks.back().width;
+	width = 0;
+	append_chunk(chunk, 0, chunk.width);
 	check();
 }
 
 RTLIL::SigSpec::SigSpec(RTLIL::Wire *wire, int width, int offset)
 {
-	chunks.push_back(RTLIL::SigChunk(wire, width, offset));
-	this->width = chunks.back().width;
+	this->width = 0;
+	RTLIL::SigChunk chunk(wire, width, offset);
+	append_chunk(chunk, 0, chunk.width);
 	check();
 }
 
 RTLIL::SigSpec::SigSpec(const std::string &str)
 {
-	chunks.push_back(RTLIL::SigChunk(str));
-	width = chunks.back().width;
+	width = 0;
+	RTLIL::SigChunk chunk(str);
+	append_chunk(chunk, 0, chunk.width);
 	check();
 }
 
 RTLIL::SigSpec::SigSpec(int val, int width)
 {
-	chunks.push_back(RTLIL::SigChunk(val, width));
-	this->width = width;
+	this->width = 0;
+	append_chunk(RTLIL::SigChunk(val, width), 0, width);
 	check();
 }
 
 RTLIL::SigSpec::SigSpec(RTLIL::State bit, int width)
 {
-	chunks.push_back(RTLIL::SigChunk(bit, width));
-	this->width = width;
+	this->width = 0;
+	append_chunk(RTLIL::SigChunk(bit, width), 0, width);
 	check();
 }
 
 RTLIL::SigSpec::SigSpec(RTLIL::SigBit bit, int width)
 {
-	if (bit.wire == NULL)
-		chunks.push_back(RTLIL::SigChunk(bit.data, width));
-	else
-		for (int i = 0; i < width; i++)
-			chunks.push_back(bit);
-	this->width = width;
+	if (bit.wire == NULL) {
+		this->width = 0;
+		append_chunk(RTLIL::SigChunk(bit.data, width), 0, width);
+	} else {
+		bits_.resize(width, bit);
+		this->width = width;
+	}
+	check();
+}
+
+RTLIL::SigSpec::SigSpec(std::vector<RTLIL::SigChunk> chunks)
+{
+	width = 0;
+	for (auto &c : chunks)
+		append_chunk(c, 0, c.width);
 	check();
 }
 
 RTLIL::SigSpec::SigSpec(std::vector<RTLIL::SigBit> bits)
 {
-	chunks.reserve(bits.size());
-	for (auto &bit : bits)
-		chunks.push_back(bit);
-	this->width = bits.size();
+	bits_.swap(bits);
+	width = bits_.size();
 	check();
 }
 
-void RTLIL::SigSpec::expand()
+void RTLIL::SigSpec::pack() const
 {
-	std::vector<RTLIL::SigChunk> new_chunks;
-	for (size_t i = 0; i < chunks.size(); i++) {
-		for (int j = 0; j < chunks[i].width; j++)
-			new_chunks.push_back(chunks[i].extract(j, 1));
+	if (bits_.empty())
+		return;
+
+	RTLIL::SigSpec *that = (RTLIL::SigSpec*)this;
+	std::vector<RTLIL::SigBit> old_bits;
+	old_bits.swap(that->bits_);
+
+	that->chunks_.clear();
+	for (auto &bit : old_bits) {
+		RTLIL::SigChunk *last = chunks_.empty() ? NULL : &that->chunks_.back();
+		if (last && bit.wire == NULL && last->wire == NULL) {
+			last->data.bits.push_back(bit.data);
+			last->width++;
+		} else if (last && bit.wire != NULL && last->wire == bit.wire && last->offset + last->width == bit.offset) {
+			last->width++;
+		} else
+			that->chunks_.push_back(bit);
 	}
-	chunks.swap(new_chunks);
-	check();
 }
 
-void RTLIL::SigSpec::optimize()
+void RTLIL::SigSpec::unpack() const
 {
-	std::vector<RTLIL::SigChunk> new_chunks;
-	for (auto &c : chunks)
-		if (new_chunks.size() == 0) {
-			new_chunks.push_back(c);
-		} else {
-			RTLIL::SigChunk &cc = new_chunks.back();
-			if (c.wire == NULL && cc.wire == NULL)
-				cc.data.bits.insert(cc.data.bits.end(), c.data.bits.begin(), c.data.bits.end());
-			if (c.wire == cc.wire && (c.wire == NULL || cc.offset + cc.width == c.offset))
-				cc.width += c.width;
-			else
-				new_chunks.push_back(c);
+	if (chunks_.empty())
+		return;
+
+	RTLIL::SigSpec *that = (RTLIL::SigSpec*)this;
+	that->bits_.reserve(width);
+	for (auto &c : chunks_)
+		for (int i = 0; i < c.width; i++)
+			that->bits_.push_back(RTLIL::SigBit(c, i));
+	that->chunks_.clear();
+}
+
+// append bits [offset, offset+length) of chunk, merging with the last chunk where possible
+void RTLIL::SigSpec::append_chunk(const RTLIL::SigChunk &chunk, int offset, int length)
+{
+	if (length <= 0)
+		return;
+	width += length;
+
+	if (!bits_.empty()) {
+		for (int i = 0; i < length; i++)
+			bits_.push_back(RTLIL::SigBit(chunk, offset + i));
+		return;
+	}
+
+	if (!chunks_.empty()) {
+		RTLIL::SigChunk &last = chunks_.back();
+		if (chunk.wire == NULL && last.wire == NULL) {
+			last.data.bits.insert(last.data.bits.end(), chunk.data.bits.begin() + offset, chunk.data.bits.begin() + offset + length);
+			last.width += length;
+			return;
+		}
+		if (chunk.wire != NULL && last.wire == chunk.wire && last.offset + last.width == chunk.offset + offset) {
+			last.width += length;
+			return;
 		}
-	chunks.swap(new_chunks);
+	}
+
+	if (offset == 0 && length == chunk.width)
+		chunks_.push_back(chunk);
+	else
+		chunks_.push_back(chunk.extract(offset, length));
+}
+
+void RTLIL::SigSpec::optimize()
+{
+	pack();
 	check();
 }
 
@@ -1481,27 +1911,36 @@ bool RTLIL::SigChunk::compare(const RTLIL::SigChunk &a, const RTLIL::SigChunk &b
 	return a.data.bits < b.data.bits;
 }
 
+// same order as RTLIL::SigChunk::compare() on single-bit chunks
+static bool sigbit_compare(const RTLIL::SigBit &a, const RTLIL::SigBit &b)
+{
+	if (a.wire != b.wire) {
+		if (a.wire == NULL || b.wire == NULL)
+			return a.wire < b.wire;
+		else if (a.wire->name != b.wire->name)
+			return a.wire->name < b.wire->name;
+		else
+			return a.wire < b.wire;
+	}
+	if (a.wire != NULL)
+		return a.offset < b.offset;
+	return a.data < b.data;
+}
+
 void RTLIL::SigSpec::sort()
 {
-	expand();
-	std::sort(chunks.begin(), chunks.end(), RTLIL::SigChunk::compare);
-	optimize();
+	unpack();
+	std::sort(bits_.begin(), bits_.end(), sigbit_compare);
+	check();
 }
 
 void RTLIL::SigSpec::sort_and_unify()
 {
-	expand();
-	std::sort(chunks.begin(), chunks.end(), RTLIL::SigChunk::compare);
-	for (size_t i = 1; i < chunks.size(); i++) {
-		RTLIL::SigChunk &ch1 = chunks[i-1];
-		RTLIL::SigChunk &ch2 = chunks[i];
-		if (!RTLIL::SigChunk::compare(ch1, ch2) && !RTLIL::SigChunk::compare(ch2, ch1)) {
-			chunks.erase(chunks.begin()+i);
-			width -= chunks[i].width;
-			i--;
-		}
-	}
-	optimize();
+	unpack();
+	std::sort(bits_.begin(), bits_.end(), sigbit_compare);
+	bits_.erase(std::unique(bits_.begin(), bits_.end()), bits_.end());
+	width = bits_.size();
+	check();
 }
 
 void RTLIL::SigSpec::replace(const RTLIL::SigSpec &pattern, const RTLIL::SigSpec &with)
@@ -1511,29 +1950,29 @@ void RTLIL::SigSpec::replace(const RTLIL::SigSpec &pattern, const RTLIL::SigSpec
 
 void RTLIL::SigSpec::replace(const RTLIL::SigSpec &pattern, const RTLIL::SigSpec &with, RTLIL::SigSpec *other) const
 {
-	int pos = 0, restart_pos = 0;
-	assert(other == NULL || width == other->width);
-	for (size_t i = 0; i < chunks.size(); i++) {
-restart:
-		const RTLIL::SigChunk &ch1 = chunks[i];
-		if (chunks[i].wire != NULL && pos >= restart_pos)
-			for (size_t j = 0, poff = 0; j < pattern.chunks.size(); j++) {
-				const RTLIL::SigChunk &ch2 = pattern.chunks[j];
-				assert(ch2.wire != NULL);
-				if (ch1.wire == ch2.wire) {
-					int lower = std::max(ch1.offset, ch2.offset);
-					int upper = std::min(ch1.offset + ch1.width, ch2.offset + ch2.width);
-					if (lower < upper) {
-						restart_pos = pos+upper-ch1.offset;
-						other->replace(pos+lower-ch1.offset, with.extract(poff+lower-ch2.offset, upper-lower));
-						goto restart;
-					}
-				}
-				poff += ch2.width;
-			}
-		pos += chunks[i].width;
+	assert(other != NULL && width == other->width);
+	assert(pattern.width == with.width);
+
+	std::map<RTLIL::SigBit, RTLIL::SigBit> rules;
+	const std::vector<RTLIL::SigBit> &pattern_bits = pattern.bits();
+	const std::vector<RTLIL::SigBit> &with_bits = with.bits();
+	for (int i = 0; i < pattern.width; i++) {
+		assert(pattern_bits[i].wire != NULL);
+		rules.insert(std::pair<RTLIL::SigBit, RTLIL::SigBit>(pattern_bits[i], with_bits[i]));
 	}
-	check();
+
+	unpack();
+	other->unpack();
+
+	for (int i = 0; i < width; i++) {
+		if (bits_[i].wire == NULL)
+			continue;
+		auto it = rules.find(bits_[i]);
+		if (it != rules.end())
+			other->bits_[i] = it->second;
+	}
+
+	other->check();
 }
 
 void RTLIL::SigSpec::remove(const RTLIL::SigSpec &pattern)
@@ -1549,29 +1988,29 @@ void RTLIL::SigSpec::remove(const RTLIL::SigSpec &pattern, RTLIL::SigSpec *other
 
 void RTLIL::SigSpec::remove2(const RTLIL::SigSpec &pattern, RTLIL::SigSpec *other)
 {
-	int pos = 0;
 	assert(other == NULL || width == other->width);
-	for (size_t i = 0; i < chunks.size(); i++) {
-restart:
-		const RTLIL::SigChunk &ch1 = chunks[i];
-		if (chunks[i].wire != NULL)
-			for (size_t j = 0; j < pattern.chunks.size(); j++) {
-				const RTLIL::SigChunk &ch2 = pattern.chunks[j];
-				assert(ch2.wire != NULL);
-				if (ch1.wire == ch2.wire) {
-					int lower = std::max(ch1.offset, ch2.offset);
-					int upper = std::min(ch1.offset + ch1.width, ch2.offset + ch2.width);
-					if (lower < upper) {
-						if (other)
-							other->remove(pos+lower-ch1.offset, upper-lower);
-						remove(pos+lower-ch1.offset, upper-lower);
-						if (i == chunks.size())
-							break;
-						goto restart;
-					}
-				}
-			}
-		pos += chunks[i].width;
+
+	std::set<RTLIL::SigBit> pattern_bits = pattern.to_sigbit_set();
+
+	unpack();
+	if (other)
+		other->unpack();
+
+	size_t j = 0;
+	for (size_t i = 0; i < bits_.size(); i++) {
+		if (bits_[i].wire != NULL && pattern_bits.count(bits_[i]))
+			continue;
+		if (other)
+			other->bits_[j] = other->bits_[i];
+		bits_[j++] = bits_[i];
+	}
+
+	bits_.resize(j);
+	width = j;
+	if (other) {
+		other->bits_.resize(j);
+		other->width = j;
+		other->check();
 	}
 	check();
 }
@@ -1581,119 +2020,100 @@ RTLIL::SigSpec RTLIL::SigSpec::extract(RTLIL::SigSpec pattern, RTLIL::SigSpec *o
 	assert(other == NULL || width == other->width);
 
 	std::set<RTLIL::SigBit> pat = pattern.to_sigbit_set();
-	std::vector<RTLIL::SigBit> bits_match = to_sigbit_vector();
-	RTLIL::SigSpec ret;
+	const std::vector<RTLIL::SigBit> &bits_match = bits();
+	const std::vector<RTLIL::SigBit> &bits_other = other ? other->bits() : bits_match;
+	std::vector<RTLIL::SigBit> ret;
 
-	if (other) {
-		std::vector<RTLIL::SigBit> bits_other = other ? other->to_sigbit_vector() : bits_match;
-		for (int i = 0; i < width; i++)
-			if (bits_match[i].wire && pat.count(bits_match[i]))
-				ret.append_bit(bits_other[i]);
-	} else {
-		for (int i = 0; i < width; i++)
-			if (bits_match[i].wire && pat.count(bits_match[i]))
-				ret.append_bit(bits_match[i]);
-	}
+	for (int i = 0; i < width; i++)
+		if (bits_match[i].wire && pat.count(bits_match[i]))
+			ret.push_back(bits_other[i]);
 
-	ret.check();
 	return ret;
 }
 
 void RTLIL::SigSpec::replace(int offset, const RTLIL::SigSpec &with)
 {
-	int pos = 0;
 	assert(offset >= 0);
 	assert(with.width >= 0);
 	assert(offset+with.width <= width);
-	remove(offset, with.width);
-	for (size_t i = 0; i < chunks.size(); i++) {
-		if (pos == offset) {
-			chunks.insert(chunks.begin()+i, with.chunks.begin(), with.chunks.end());
-			width += with.width;
-			check();
-			return;
-		}
-		pos += chunks[i].width;
+
+	if (chunks_.empty()) {
+		const std::vector<RTLIL::SigBit> &with_bits = with.bits();
+		std::copy(with_bits.begin(), with_bits.end(), bits_.begin() + offset);
+	} else {
+		RTLIL::SigSpec old = *this;
+		chunks_.clear();
+		width = 0;
+		append(old.extract(0, offset));
+		append(with);
+		append(old.extract(offset+with.width, old.width-offset-with.width));
 	}
-	assert(pos == offset);
-	chunks.insert(chunks.end(), with.chunks.begin(), with.chunks.end());
-	width += with.width;
 	check();
 }
 
 void RTLIL::SigSpec::remove_const()
 {
-	for (size_t i = 0; i < chunks.size(); i++) {
-		if (chunks[i].wire != NULL)
-			continue;
-		width -= chunks[i].width;
-		chunks.erase(chunks.begin() + (i--));
+	if (chunks_.empty()) {
+		size_t j = 0;
+		for (size_t i = 0; i < bits_.size(); i++)
+			if (bits_[i].wire != NULL)
+				bits_[j++] = bits_[i];
+		bits_.resize(j);
+		width = j;
+	} else {
+		std::vector<RTLIL::SigChunk> old_chunks;
+		old_chunks.swap(chunks_);
+		width = 0;
+		for (auto &c : old_chunks)
+			if (c.wire != NULL)
+				append_chunk(c, 0, c.width);
 	}
 	check();
 }
 
 void RTLIL::SigSpec::remove(int offset, int length)
 {
-	int pos = 0;
 	assert(offset >= 0);
 	assert(length >= 0);
 	assert(offset+length <= width);
-	for (size_t i = 0; i < chunks.size(); i++) {
-		int orig_width = chunks[i].width;
-		if (pos+chunks[i].width > offset && pos < offset+length) {
-			int off = offset - pos;
-			int len = length;
-			if (off < 0) {
-				len += off;
-				off = 0;
-			}
-			if (len > chunks[i].width-off)
-				len = chunks[i].width-off;
-			RTLIL::SigChunk lsb_chunk = chunks[i].extract(0, off);
-			RTLIL::SigChunk msb_chunk = chunks[i].extract(off+len, chunks[i].width-off-len);
-			if (lsb_chunk.width == 0 && msb_chunk.width == 0) {
-				chunks.erase(chunks.begin()+i);
-				i--;
-			} else if (lsb_chunk.width == 0 && msb_chunk.width != 0) {
-				chunks[i] = msb_chunk;
-			} else if (lsb_chunk.width != 0 && msb_chunk.width == 0) {
-				chunks[i] = lsb_chunk;
-			} else if (lsb_chunk.width != 0 && msb_chunk.width != 0) {
-				chunks[i] = lsb_chunk;
-				chunks.insert(chunks.begin()+i+1, msb_chunk);
-				i++;
-			} else
-				assert(0);
-			width -= len;
-		}
-		pos += orig_width;
+
+	if (chunks_.empty()) {
+		bits_.erase(bits_.begin() + offset, bits_.begin() + offset + length);
+		width = bits_.size();
+	} else {
+		RTLIL::SigSpec old = *this;
+		chunks_.clear();
+		width = 0;
+		append(old.extract(0, offset));
+		append(old.extract(offset+length, old.width-offset-length));
 	}
 	check();
 }
 
 RTLIL::SigSpec RTLIL::SigSpec::extract(int offset, int length) const
 {
-	int pos = 0;
 	RTLIL::SigSpec ret;
 	assert(offset >= 0);
 	assert(length >= 0);
 	assert(offset+length <= width);
-	for (size_t i = 0; i < chunks.size(); i++) {
-		if (pos+chunks[i].width > offset && pos < offset+length) {
+
+	if (chunks_.empty()) {
+		ret.bits_.insert(ret.bits_.end(), bits_.begin() + offset, bits_.begin() + offset + length);
+		ret.width = length;
+		return ret;
+	}
+
+	int pos = 0;
+	for (size_t i = 0; i < chunks_.size() && length > 0; i++) {
+		const RTLIL::SigChunk &c = chunks_[i];
+		if (pos+c.width > offset) {
 			int off = offset - pos;
-			int len = length;
-			if (off < 0) {
-				len += off;
-				off = 0;
-			}
-			if (len > chunks[i].width-off)
-				len = chunks[i].width-off;
-			ret.chunks.push_back(chunks[i].extract(off, len));
-			ret.width += len;
+			int len = std::min(length, c.width-off);
+			ret.append_chunk(c, off, len);
 			offset += len;
 			length -= len;
 		}
-		pos += chunks[i].width;
+		pos += c.width;
 	}
 	assert(length == 0);
 	ret.check();
@@ -1702,28 +2122,51 @@ RTLIL::SigSpec RTLIL::SigSpec::extract(int offset, int length) const
 
 void RTLIL::SigSpec::append(const RTLIL::SigSpec &signal)
 {
-	for (size_t i = 0; i < signal.chunks.size(); i++) {
-		chunks.push_back(signal.chunks[i]);
-		width += signal.chunks[i].width;
+	if (signal.width == 0)
+		return;
+
+	if (&signal == this) {
+		RTLIL::SigSpec tmp = signal;
+		append(tmp);
+		return;
+	}
+
+	if (width == 0) {
+		*this = signal;
+		return;
+	}
+
+	if (!bits_.empty() && !signal.bits_.empty()) {
+		bits_.insert(bits_.end(), signal.bits_.begin(), signal.bits_.end());
+		width += signal.width;
+	} else if (!signal.chunks_.empty()) {
+		for (auto &c : signal.chunks_)
+			append_chunk(c, 0, c.width);
+	} else {
+		for (auto &bit : signal.bits_)
+			append_bit(bit);
 	}
 	// check();
 }
 
 void RTLIL::SigSpec::append_bit(const RTLIL::SigBit &bit)
 {
-	if (chunks.size() == 0)
-		chunks.push_back(bit);
+	if (!bits_.empty())
+		bits_.push_back(bit);
+	else if (chunks_.empty())
+		chunks_.push_back(bit);
 	else
 		if (bit.wire == NULL)
-			if (chunks.back().wire == NULL)
-				chunks.back().data.bits.push_back(bit.data);
-			else
-				chunks.push_back(bit);
+			if (chunks_.back().wire == NULL) {
+				chunks_.back().data.bits.push_back(bit.data);
+				chunks_.back().width++;
+			} else
+				chunks_.push_back(bit);
 		else
-			if (chunks.back().wire == bit.wire && chunks.back().offset + chunks.back().width == bit.offset)
-				chunks.back().width++;
+			if (chunks_.back().wire == bit.wire && chunks_.back().offset + chunks_.back().width == bit.offset)
+				chunks_.back().width++;
 			else
-				chunks.push_back(bit);
+				chunks_.push_back(bit);
 	width++;
 	// check();
 }
@@ -1733,21 +2176,21 @@ bool RTLIL::SigSpec::combine(RTLIL::SigSpec signal, RTLIL::State freeState, bool
 	bool no_collisions = true;
 
 	assert(width == signal.width);
-	expand();
-	signal.expand();
+	unpack();
+	signal.unpack();
 
-	for (size_t i = 0; i < chunks.size(); i++) {
-		bool self_free = chunks[i].wire == NULL && chunks[i].data.bits[0] == freeState;
-		bool other_free = signal.chunks[i].wire == NULL && signal.chunks[i].data.bits[0] == freeState;
+	for (int i = 0; i < width; i++) {
+		bool self_free = bits_[i].wire == NULL && bits_[i].data == freeState;
+		bool other_free = signal.bits_[i].wire == NULL && signal.bits_[i].data == freeState;
 		if (!self_free && !other_free) {
 			if (override)
-				chunks[i] = signal.chunks[i];
+				bits_[i] = signal.bits_[i];
 			else
-				chunks[i] = RTLIL::SigChunk(RTLIL::State::Sx, 1);
+				bits_[i] = RTLIL::SigBit(RTLIL::State::Sx);
 			no_collisions = false;
 		}
 		if (self_free && !other_free)
-			chunks[i] = signal.chunks[i];
+			bits_[i] = signal.bits_[i];
 	}
 
 	optimize();
@@ -1789,9 +2232,18 @@ void RTLIL::SigSpec::extend_u0(int width, bool is_signed)
 
 void RTLIL::SigSpec::check() const
 {
+	if (!bits_.empty()) {
+		assert(chunks_.empty());
+		assert(bits_.size() == (size_t)width);
+		for (auto &bit : bits_)
+			if (bit.wire != NULL)
+				assert(bit.offset >= 0 && bit.offset < bit.wire->width);
+		return;
+	}
+
 	int w = 0;
-	for (size_t i = 0; i < chunks.size(); i++) {
-		const RTLIL::SigChunk chunk = chunks[i];
+	for (size_t i = 0; i < chunks_.size(); i++) {
+		const RTLIL::SigChunk &chunk = chunks_[i];
 		if (chunk.wire == NULL) {
 			assert(chunk.offset == 0);
 			assert(chunk.data.bits.size() == (size_t)chunk.width);
@@ -1811,16 +2263,15 @@ bool RTLIL::SigSpec::operator <(const RTLIL::SigSpec &other) const
 	if (width != other.width)
 		return width < other.width;
 
-	RTLIL::SigSpec a = *this, b = other;
-	a.optimize();
-	b.optimize();
+	pack();
+	other.pack();
 
-	if (a.chunks.size() != b.chunks.size())
-		return a.chunks.size() < b.chunks.size();
+	if (chunks_.size() != other.chunks_.size())
+		return chunks_.size() < other.chunks_.size();
 
-	for (size_t i = 0; i < a.chunks.size(); i++)
-		if (a.chunks[i] != b.chunks[i])
-			return a.chunks[i] < b.chunks[i];
+	for (size_t i = 0; i < chunks_.size(); i++)
+		if (chunks_[i] != other.chunks_[i])
+			return chunks_[i] < other.chunks_[i];
 
 	return false;
 }
@@ -1830,18 +2281,13 @@ bool RTLIL::SigSpec::operator ==(const RTLIL::SigSpec &other) const
 	if (width != other.width)
 		return false;
 
-	RTLIL::SigSpec a = *this, b = other;
-	a.optimize();
-	b.optimize();
+	if (!bits_.empty() && !other.bits_.empty())
+		return bits_ == other.bits_;
 
-	if (a.chunks.size() != b.chunks.size())
-		return false;
+	pack();
+	other.pack();
 
-	for (size_t i = 0; i < a.chunks.size(); i++)
-		if (a.chunks[i] != b.chunks[i])
-			return false;
-
-	return true;
+	return chunks_ == other.chunks_;
 }
 
 bool RTLIL::SigSpec::operator !=(const RTLIL::SigSpec &other) const
@@ -1853,7 +2299,10 @@ bool RTLIL::SigSpec::operator !=(const RTLIL::SigSpec &other) const
 
 bool RTLIL::SigSpec::is_fully_const() const
 {
-	for (auto it = chunks.begin(); it != chunks.end(); it++)
+	for (auto &bit : bits_)
+		if (bit.wire != NULL)
+			return false;
+	for (auto it = chunks_.begin(); it != chunks_.end(); it++)
 		if (it->width > 0 && it->wire != NULL)
 			return false;
 	return true;
@@ -1861,7 +2310,10 @@ bool RTLIL::SigSpec::is_fully_const() const
 
 bool RTLIL::SigSpec::is_fully_def() const
 {
-	for (auto it = chunks.begin(); it != chunks.end(); it++) {
+	for (auto &bit : bits_)
+		if (bit.wire != NULL || (bit.data != RTLIL::State::S0 && bit.data != RTLIL::State::S1))
+			return false;
+	for (auto it = chunks_.begin(); it != chunks_.end(); it++) {
 		if (it->width > 0 && it->wire != NULL)
 			return false;
 		for (size_t i = 0; i < it->data.bits.size(); i++)
@@ -1873,7 +2325,10 @@ bool RTLIL::SigSpec::is_fully_def() const
 
 bool RTLIL::SigSpec::is_fully_undef() const
 {
-	for (auto it = chunks.begin(); it != chunks.end(); it++) {
+	for (auto &bit : bits_)
+		if (bit.wire != NULL || (bit.data != RTLIL::State::Sx && bit.data != RTLIL::State::Sz))
+			return false;
+	for (auto it = chunks_.begin(); it != chunks_.end(); it++) {
 		if (it->width > 0 && it->wire != NULL)
 			return false;
 		for (size_t i = 0; i < it->data.bits.size(); i++)
@@ -1885,7 +2340,10 @@ bool RTLIL::SigSpec::is_fully_undef() const
 
 bool RTLIL::SigSpec::has_marked_bits() const
 {
-	for (auto it = chunks.begin(); it != chunks.end(); it++)
+	for (auto &bit : bits_)
+		if (bit.wire == NULL && bit.data == RTLIL::State::Sm)
+			return true;
+	for (auto it = chunks_.begin(); it != chunks_.end(); it++)
 		if (it->width > 0 && it->wire == NULL) {
 			for (size_t i = 0; i < it->data.bits.size(); i++)
 				if (it->data.bits[i] == RTLIL::State::Sm)
@@ -1897,28 +2355,27 @@ bool RTLIL::SigSpec::has_marked_bits() const
 bool RTLIL::SigSpec::as_bool() const
 {
 	assert(is_fully_const());
-	SigSpec sig = *this;
-	sig.optimize();
-	if (sig.width)
-		return sig.chunks[0].data.as_bool();
+	pack();
+	if (width)
+		return chunks_[0].data.as_bool();
 	return false;
 }
 
 int RTLIL::SigSpec::as_int() const
 {
 	assert(is_fully_const());
-	SigSpec sig = *this;
-	sig.optimize();
-	if (sig.width)
-		return sig.chunks[0].data.as_int();
+	pack();
+	if (width)
+		return chunks_[0].data.as_int();
 	return 0;
 }
 
 std::string RTLIL::SigSpec::as_string() const
 {
+	pack();
 	std::string str;
-	for (size_t i = chunks.size(); i > 0; i--) {
-		const RTLIL::SigChunk &chunk = chunks[i-1];
+	for (size_t i = chunks_.size(); i > 0; i--) {
+		const RTLIL::SigChunk &chunk = chunks_[i-1];
 		if (chunk.wire != NULL)
 			for (int j = 0; j < chunk.width; j++)
 				str += "?";
@@ -1931,10 +2388,9 @@ std::string RTLIL::SigSpec::as_string() const
 RTLIL::Const RTLIL::SigSpec::as_const() const
 {
 	assert(is_fully_const());
-	SigSpec sig = *this;
-	sig.optimize();
-	if (sig.width)
-		return sig.chunks[0].data;
+	pack();
+	if (width)
+		return chunks_[0].data;
 	return RTLIL::Const();
 }
 
@@ -1960,8 +2416,8 @@ bool RTLIL::SigSpec::match(std::string pattern) const
 
 std::set<RTLIL::SigBit> RTLIL::SigSpec::to_sigbit_set() const
 {
-	std::set<RTLIL::SigBit> sigbits;
-	for (auto &c : chunks)
+	std::set<RTLIL::SigBit> sigbits(bits_.begin(), bits_.end());
+	for (auto &c : chunks_)
 		for (int i = 0; i < c.width; i++)
 			sigbits.insert(RTLIL::SigBit(c, i));
 	return sigbits;
@@ -1969,18 +2425,15 @@ std::set<RTLIL::SigBit> RTLIL::SigSpec::to_sigbit_set() const
 
 std::vector<RTLIL::SigBit> RTLIL::SigSpec::to_sigbit_vector() const
 {
-	std::vector<RTLIL::SigBit> sigbits;
-	sigbits.reserve(width);
-	for (auto &c : chunks)
-		for (int i = 0; i < c.width; i++)
-			sigbits.push_back(RTLIL::SigBit(c, i));
-	return sigbits;
+	return bits();
 }
 
 RTLIL::SigBit RTLIL::SigSpec::to_single_sigbit() const
 {
 	log_assert(width == 1);
-	for (auto &c : chunks)
+	if (!bits_.empty())
+		return bits_[0];
+	for (auto &c : chunks_)
 		if (c.width)
 			return RTLIL::SigBit(c);
 	log_abort();
@@ -2103,7 +2556,7 @@ bool RTLIL::SigSpec::parse_rhs(const RTLIL::SigSpec &lhs, RTLIL::SigSpec &sig, R
 		return true;
 	}
 
-	if (lhs.chunks.size() == 1) {
+	if (lhs.chunks().size() == 1) {
 		char *p = (char*)str.c_str(), *endptr;
 		long long int val = strtoll(p, &endptr, 10);
 		if (endptr && endptr != p && *endptr == 0) {
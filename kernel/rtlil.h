@@ -25,12 +25,23 @@
 #include <vector>
 #include <string>
 #include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+#include "kernel/hashmap.h"
+
+// implemented in kernel/modindex.h
+struct ModIndex;
 
 std::string stringf(const char *fmt, ...);
 
 namespace RTLIL
 {
-	enum State {
+	// one byte per state, so that the const_* functions in calc.cc
+	// can process eight states at once in a 64 bit word
+	enum State : unsigned char {
 		S0 = 0,
 		S1 = 1,
 		Sx = 2, // undefined value or conflict
@@ -56,7 +67,16 @@ namespace RTLIL
 		CONST_FLAG_REAL   = 4   // unused -- to be used for parameters
 	};
 
-	extern int autoidx;
+	extern std::atomic<int> autoidx;
+
+	// Pass::run_modules() points this to a counter of its own for each module
+	// that is processed by a worker thread, so that the names created by
+	// new_id() do not depend on the order in which the threads run
+	extern thread_local int *job_autoidx;
+
+	// set by Pass::run_modules() while worker threads are running, switches
+	// the global pools (IdString, Wire and Cell objects) to thread-safe mode
+	extern bool multi_threaded;
 
 	struct Const;
 	struct Selection;
@@ -75,36 +95,194 @@ namespace RTLIL
 
 	typedef std::pair<SigSpec, SigSpec> SigSig;
 
-#ifdef NDEBUG
-	typedef std::string IdString;
-#else
-	struct IdString : public std::string {
-		IdString() { }
-		IdString(std::string str) : std::string(str) {
-			check();
+	// IdString is a reference to an interned string in a global, reference-counted
+	// string pool. Copying an IdString and comparing two IdStrings for equality
+	// only touches the 32-bit index. The lexicographic operator<() is kept so that
+	// std::map and std::set containers keyed by IdString iterate in the same
+	// (name sorted) order as before.
+	//
+	// The pool entries are stored in fixed-size chunks that are never moved, so
+	// that str() does not need a lock while other threads add strings. While
+	// RTLIL::multi_threaded is set the reference counts are updated atomically
+	// and the lookup table is protected by storage_t::mutex.
+
+	struct IdString
+	{
+		struct entry_t {
+			std::string *str;
+			std::atomic<int> refcount;
+		};
+
+		static const int chunk_bits = 16;
+		static const int chunk_size = 1 << chunk_bits;
+		static const int max_chunks = 1 << 15;
+
+		struct storage_t {
+			entry_t *chunks[max_chunks];
+			int size;
+			std::vector<int> free_indices;
+			// open addressing (linear probing) hash table of {hash, index}
+			// pairs, index 0 marks an empty slot
+			std::vector<std::pair<unsigned int, int>> hashtable;
+			int hashtable_used;
+			// small direct-mapped cache for repeated lookups of the same char
+			// pointer (usually a string literal), validated by strcmp(). Not
+			// used while RTLIL::multi_threaded is set.
+			std::pair<const char*, int> lookup_cache[1024];
+			std::mutex mutex;
+			storage_t();
+			entry_t &entry(int idx) { return chunks[idx >> chunk_bits][idx & (chunk_size-1)]; }
+		};
+
+		// allocated on first use and never freed, so that IdString objects with
+		// static storage duration can be created and destroyed in any order
+		static storage_t *global_storage_;
+
+		static storage_t &storage() {
+			if (global_storage_ == NULL)
+				global_storage_ = new storage_t;
+			return *global_storage_;
+		}
+
+		static int get_reference_worker(const char *p);
+		static void put_reference_worker(int idx);
+
+		static inline int get_reference(const char *p) {
+			if (p[0] == 0)
+				return 0;
+			storage_t &stor = storage();
+			if (multi_threaded) {
+				std::lock_guard<std::mutex> lock(stor.mutex);
+				return get_reference_worker(p);
+			}
+			std::pair<const char*, int> &cache = stor.lookup_cache[(uintptr_t(p) >> 2) & 1023];
+			if (cache.first == p && stor.entry(cache.second).str != NULL && !strcmp(stor.entry(cache.second).str->c_str(), p)) {
+				get_reference(cache.second);
+				return cache.second;
+			}
+			int idx = get_reference_worker(p);
+			cache.first = p, cache.second = idx;
+			return idx;
 		}
-		IdString(const char *s) : std::string(s) {
-			check();
+
+		static inline void get_reference(int idx) {
+			if (idx == 0)
+				return;
+			std::atomic<int> &refcount = global_storage_->entry(idx).refcount;
+			if (multi_threaded)
+				refcount.fetch_add(1);
+			else
+				refcount.store(refcount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		static inline void put_reference(int idx) {
+			if (idx == 0)
+				return;
+			std::atomic<int> &refcount = global_storage_->entry(idx).refcount;
+			if (multi_threaded) {
+				if (refcount.fetch_sub(1) == 1)
+					put_reference_worker(idx);
+			} else {
+				int n = refcount.load(std::memory_order_relaxed) - 1;
+				refcount.store(n, std::memory_order_relaxed);
+				if (n == 0)
+					put_reference_worker(idx);
+			}
 		}
-		IdString &operator=(const std::string &str) {
-			std::string::operator=(str);
-			check();
+
+		static size_t pool_size();
+		static size_t pool_bytes();
+
+		int index_;
+
+		IdString() : index_(0) { }
+		IdString(const char *str) : index_(get_reference(str)) { check(); }
+		IdString(const std::string &str) : index_(get_reference(str.c_str())) { check(); }
+		IdString(const IdString &other) : index_(other.index_) { get_reference(index_); }
+		IdString(IdString &&other) : index_(other.index_) { other.index_ = 0; }
+		~IdString() { put_reference(index_); }
+
+		IdString &operator=(const IdString &rhs) {
+			get_reference(rhs.index_);
+			put_reference(index_);
+			index_ = rhs.index_;
 			return *this;
 		}
-		IdString &operator=(const char *s) {
-			std::string::operator=(s);
-			check();
+
+		IdString &operator=(IdString &&rhs) {
+			if (this != &rhs) {
+				put_reference(index_);
+				index_ = rhs.index_;
+				rhs.index_ = 0;
+			}
 			return *this;
 		}
-		bool operator<(const IdString &rhs) {
-			check(), rhs.check();
-			return std::string(*this) < std::string(rhs);
+
+		IdString &operator=(const char *rhs) {
+			return *this = IdString(rhs);
+		}
+
+		IdString &operator=(const std::string &rhs) {
+			return *this = IdString(rhs);
+		}
+
+		IdString &operator+=(const std::string &rhs) {
+			return *this = IdString(str() + rhs);
+		}
+
+		void clear() {
+			*this = IdString();
 		}
+
+		const std::string &str() const {
+			return *storage().entry(index_).str;
+		}
+
+		operator const std::string&() const {
+			return str();
+		}
+
+		const char *c_str() const { return str().c_str(); }
+		size_t size() const { return str().size(); }
+		bool empty() const { return index_ == 0; }
+		char operator[](size_t i) const { return str()[i]; }
+		char at(size_t i) const { return str().at(i); }
+		std::string substr(size_t pos = 0, size_t len = std::string::npos) const { return str().substr(pos, len); }
+		size_t find(const std::string &s, size_t pos = 0) const { return str().find(s, pos); }
+		size_t find(char c, size_t pos = 0) const { return str().find(c, pos); }
+		size_t find_first_of(const char *s, size_t pos = 0) const { return str().find_first_of(s, pos); }
+		size_t find_last_of(const char *s, size_t pos = std::string::npos) const { return str().find_last_of(s, pos); }
+		int compare(size_t pos, size_t len, const char *s) const { return str().compare(pos, len, s); }
+
+		bool operator==(const IdString &rhs) const { return index_ == rhs.index_; }
+		bool operator!=(const IdString &rhs) const { return index_ != rhs.index_; }
+		bool operator==(const char *rhs) const { return strcmp(c_str(), rhs) == 0; }
+		bool operator!=(const char *rhs) const { return strcmp(c_str(), rhs) != 0; }
+		bool operator==(const std::string &rhs) const { return str() == rhs; }
+		bool operator!=(const std::string &rhs) const { return str() != rhs; }
+
+		bool operator<(const IdString &rhs) const {
+			return index_ != rhs.index_ && strcmp(c_str(), rhs.c_str()) < 0;
+		}
+
 		void check() const {
+#ifndef NDEBUG
 			assert(empty() || (size() >= 2 && (at(0) == '$' || at(0) == '\\')));
+#endif
 		}
 	};
-#endif
+
+	static inline bool operator==(const char *lhs, const IdString &rhs) { return rhs == lhs; }
+	static inline bool operator!=(const char *lhs, const IdString &rhs) { return rhs != lhs; }
+	static inline bool operator==(const std::string &lhs, const IdString &rhs) { return rhs == lhs; }
+	static inline bool operator!=(const std::string &lhs, const IdString &rhs) { return rhs != lhs; }
+
+	static inline std::string operator+(const IdString &lhs, const std::string &rhs) { return lhs.str() + rhs; }
+	static inline std::string operator+(const IdString &lhs, const char *rhs) { return lhs.str() + rhs; }
+	static inline std::string operator+(const IdString &lhs, char rhs) { return lhs.str() + rhs; }
+	static inline std::string operator+(const std::string &lhs, const IdString &rhs) { return lhs + rhs.str(); }
+	static inline std::string operator+(const char *lhs, const IdString &rhs) { return lhs + rhs.str(); }
+	static inline std::string operator+(char lhs, const IdString &rhs) { return lhs + rhs.str(); }
 
 	static IdString escape_id(std::string str) __attribute__((unused));
 	static IdString escape_id(std::string str) {
@@ -127,17 +305,27 @@ namespace RTLIL
 		return str.c_str();
 	}
 
+	// the number for the next auto-generated name (see job_autoidx)
+	static inline int next_autoidx() {
+		return job_autoidx != NULL ? (*job_autoidx)++ : autoidx++;
+	}
+
+	// NEW_ID keeps one NewIdPrefix per call site (in a function-local static),
+	// so that the "$auto$<file>:<line>:<function>$" part of the names is built
+	// only once and each new name only appends the next number
+	struct NewIdPrefix {
+		std::string prefix;
+		NewIdPrefix(const char *file, int line, const char *func);
+		IdString next() const;
+	};
+
 	static IdString new_id(std::string file, int line, std::string func) __attribute__((unused));
 	static IdString new_id(std::string file, int line, std::string func) {
-		std::string str = "$auto$";
-		size_t pos = file.find_last_of('/');
-		str += pos != std::string::npos ? file.substr(pos+1) : file;
-		str += stringf(":%d:%s$%d", line, func.c_str(), autoidx++);
-		return str;
+		return NewIdPrefix(file.c_str(), line, func.c_str()).next();
 	}
 
 #define NEW_ID \
-	RTLIL::new_id(__FILE__, __LINE__, __FUNCTION__)
+	({ static const RTLIL::NewIdPrefix new_id_prefix(__FILE__, __LINE__, __FUNCTION__); new_id_prefix.next(); })
 
 #define NEW_WIRE(_mod, _width) \
 	(_mod)->new_wire(_width, NEW_ID)
@@ -149,6 +337,8 @@ namespace RTLIL
 	};
 
 	// see calc.cc for the implementation of this functions
+	// (const_disable_fastpath forces BigInteger arithmetic, used by "test_calc")
+	extern bool const_disable_fastpath;
 	RTLIL::Const const_not         (const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len);
 	RTLIL::Const const_and         (const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len);
 	RTLIL::Const const_or          (const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len);
@@ -189,8 +379,24 @@ namespace RTLIL
 	RTLIL::Const const_pos         (const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len);
 	RTLIL::Const const_bu0         (const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len);
 	RTLIL::Const const_neg         (const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len);
+
+	// RTLIL::Wire and RTLIL::Cell objects are allocated from pools of
+	// fixed-size slots (see rtlil.cc). malloc_bytes is the estimated size
+	// the same objects would take as individual malloc() chunks.
+	struct PoolStats {
+		size_t slot_size, live_objects, peak_objects, total_slots, block_bytes, malloc_bytes;
+	};
+	void get_pool_stats(PoolStats &wire_stats, PoolStats &cell_stats);
 };
 
+namespace std {
+	template<> struct hash<RTLIL::IdString> {
+		size_t operator()(const RTLIL::IdString &id) const {
+			return id.index_;
+		}
+	};
+}
+
 struct RTLIL::Const {
 	int flags;
 	std::vector<RTLIL::State> bits;
@@ -240,6 +446,16 @@ struct RTLIL::Design {
 	~Design();
 	void check();
 	void optimize();
+
+	// Modules can be shared (copy-on-write) between designs, this is used for
+	// cheap design snapshots ("design -save", "design -push"). A shared module
+	// must not be modified. Pass::extra_args() calls unshare_modules() for the
+	// selected modules before a pass starts its work, and code that deletes a
+	// module from a design must use release_module() instead of delete.
+	static RTLIL::Module *share_module(RTLIL::Module *module);
+	static void release_module(RTLIL::Module *module);
+	RTLIL::Module *unshare_module(RTLIL::IdString mod_name);
+	void unshare_modules(bool only_selected = false);
 	bool selected_module(RTLIL::IdString mod_name) const;
 	bool selected_whole_module(RTLIL::IdString mod_name) const;
 	bool selected_member(RTLIL::IdString mod_name, RTLIL::IdString memb_name) const;
@@ -274,21 +490,35 @@ struct RTLIL::Design {
 struct RTLIL::Module {
 	RTLIL::IdString name;
 	std::set<RTLIL::IdString> avail_parameters;
-	std::map<RTLIL::IdString, RTLIL::Wire*> wires;
-	std::map<RTLIL::IdString, RTLIL::Memory*> memories;
-	std::map<RTLIL::IdString, RTLIL::Cell*> cells;
-	std::map<RTLIL::IdString, RTLIL::Process*> processes;
+	HashMap<RTLIL::IdString, RTLIL::Wire*> wires;
+	HashMap<RTLIL::IdString, RTLIL::Memory*> memories;
+	HashMap<RTLIL::IdString, RTLIL::Cell*> cells;
+	HashMap<RTLIL::IdString, RTLIL::Process*> processes;
 	std::vector<RTLIL::SigSig> connections;
+	ModIndex *modindex;
+	// number of designs sharing this module in addition to its first owner
+	int share_count;
+	// globally unique value that is replaced by a new one by touch() whenever
+	// the module is modified (the Module API calls touch(), see also
+	// Pass::tracks_changes)
+	uint64_t generation;
 	RTLIL_ATTRIBUTE_MEMBERS
+	Module();
 	virtual ~Module();
-	virtual RTLIL::IdString derive(RTLIL::Design *design, std::map<RTLIL::IdString, RTLIL::Const> parameters);
+	virtual RTLIL::IdString derive(RTLIL::Design *design, HashMap<RTLIL::IdString, RTLIL::Const> parameters);
 	virtual size_t count_id(RTLIL::IdString id);
 	virtual void check();
 	virtual void optimize();
 	RTLIL::Wire *new_wire(int width, RTLIL::IdString name);
 	void add(RTLIL::Wire *wire);
 	void add(RTLIL::Cell *cell);
+	void remove(RTLIL::Cell *cell);
+	void connect(const RTLIL::SigSig &conn);
 	void fixup_ports();
+	void touch();
+
+	ModIndex *index();
+	void invalidate_index();
 
 	template<typename T> void rewrite_sigspecs(T functor);
 	void cloneInto(RTLIL::Module *new_mod) const;
@@ -376,6 +606,8 @@ struct RTLIL::Wire {
 	bool port_input, port_output;
 	RTLIL_ATTRIBUTE_MEMBERS
 	Wire();
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
 };
 
 struct RTLIL::Memory {
@@ -388,10 +620,12 @@ struct RTLIL::Memory {
 struct RTLIL::Cell {
 	RTLIL::IdString name;
 	RTLIL::IdString type;
-	std::map<RTLIL::IdString, RTLIL::SigSpec> connections;
-	std::map<RTLIL::IdString, RTLIL::Const> parameters;
+	HashMap<RTLIL::IdString, RTLIL::SigSpec> connections;
+	HashMap<RTLIL::IdString, RTLIL::Const> parameters;
 	RTLIL_ATTRIBUTE_MEMBERS
 	void optimize();
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
 
 	template<typename T> void rewrite_sigspecs(T functor);
 };
@@ -437,7 +671,17 @@ struct RTLIL::SigBit {
 };
 
 struct RTLIL::SigSpec {
-	std::vector<RTLIL::SigChunk> chunks; // LSB at index 0
+private:
+	// a SigSpec is either packed (chunks_, adjacent chunks always merged) or
+	// unpacked (bits_, one entry per bit). the representation is switched
+	// lazily by the accessors below, so a const SigSpec may change it too.
+	std::vector<RTLIL::SigChunk> chunks_; // LSB at index 0
+	std::vector<RTLIL::SigBit> bits_; // LSB at index 0
+	void pack() const;
+	void unpack() const;
+	void append_chunk(const RTLIL::SigChunk &chunk, int offset, int length);
+
+public:
 	int width;
 	SigSpec();
 	SigSpec(const RTLIL::Const &data);
@@ -447,8 +691,14 @@ struct RTLIL::SigSpec {
 	SigSpec(int val, int width = 32);
 	SigSpec(RTLIL::State bit, int width = 1);
 	SigSpec(RTLIL::SigBit bit, int width = 1);
+	SigSpec(std::vector<RTLIL::SigChunk> chunks);
 	SigSpec(std::vector<RTLIL::SigBit> bits);
-	void expand();
+
+	const std::vector<RTLIL::SigChunk> &chunks() const { if (!bits_.empty()) pack(); return chunks_; }
+	const std::vector<RTLIL::SigBit> &bits() const { if (!chunks_.empty()) unpack(); return bits_; }
+	RTLIL::SigBit &operator[](int index) { if (!chunks_.empty()) unpack(); return bits_.at(index); }
+	const RTLIL::SigBit &operator[](int index) const { if (!chunks_.empty()) unpack(); return bits_.at(index); }
+
 	void optimize();
 	RTLIL::SigSpec optimized() const;
 	void sort();
@@ -490,8 +740,8 @@ struct RTLIL::SigSpec {
 };
 
 inline RTLIL::SigBit::SigBit(const RTLIL::SigSpec &sig) {
-	assert(sig.width == 1 && sig.chunks.size() == 1);
-	*this = SigBit(sig.chunks[0]);
+	assert(sig.width == 1 && sig.chunks().size() == 1);
+	*this = SigBit(sig.chunks()[0]);
 }
 
 struct RTLIL::CaseRule {
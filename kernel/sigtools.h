@@ -23,79 +23,209 @@
 #include "kernel/rtlil.h"
 #include "kernel/log.h"
 #include <assert.h>
+#include <algorithm>
 #include <set>
 
+// Dense numbering of wire bits, used by the containers below. Every wire is
+// assigned a contiguous range of indices the first time one of its bits is
+// seen. Bits beyond the width a wire had at that point (i.e. when the wire has
+// been resized since) are numbered individually, so indices never change.
+
+struct SigBitIndex
+{
+	struct range_t {
+		int offset, width;
+	};
+
+	HashMap<RTLIL::Wire*, range_t> wire_ranges;
+	std::map<std::pair<RTLIL::Wire*,int>, int> extra_bits;
+	std::vector<std::pair<int, RTLIL::SigBit>> range_starts;
+	int num_indices;
+
+	RTLIL::Wire *cached_wire;
+	range_t cached_range;
+
+	SigBitIndex() : num_indices(0), cached_wire(NULL) { }
+
+	void clear()
+	{
+		wire_ranges.clear();
+		extra_bits.clear();
+		range_starts.clear();
+		num_indices = 0;
+		cached_wire = NULL;
+	}
+
+	void swap(SigBitIndex &other)
+	{
+		wire_ranges.swap(other.wire_ranges);
+		extra_bits.swap(other.extra_bits);
+		range_starts.swap(other.range_starts);
+		std::swap(num_indices, other.num_indices);
+		std::swap(cached_wire, other.cached_wire);
+		std::swap(cached_range, other.cached_range);
+	}
+
+	size_t size() const
+	{
+		return num_indices;
+	}
+
+	// returns -1 for bits that have not been numbered yet, unless create is set
+	int operator()(RTLIL::Wire *wire, int offset, bool create = false)
+	{
+		if (wire != cached_wire) {
+			auto it = wire_ranges.find(wire);
+			if (it == wire_ranges.end()) {
+				if (!create)
+					return -1;
+				range_t &range = wire_ranges[wire];
+				range.offset = num_indices;
+				range.width = wire->width;
+				if (range.width > 0)
+					range_starts.push_back(std::pair<int, RTLIL::SigBit>(num_indices, RTLIL::SigBit(wire, 0)));
+				num_indices += wire->width;
+				it = wire_ranges.find(wire);
+			}
+			cached_wire = wire;
+			cached_range = it->second;
+		}
+		if (offset < cached_range.width)
+			return cached_range.offset + offset;
+		auto it = extra_bits.find(std::pair<RTLIL::Wire*,int>(wire, offset));
+		if (it != extra_bits.end())
+			return it->second;
+		if (!create)
+			return -1;
+		extra_bits[std::pair<RTLIL::Wire*,int>(wire, offset)] = num_indices;
+		range_starts.push_back(std::pair<int, RTLIL::SigBit>(num_indices, RTLIL::SigBit(wire, offset)));
+		return num_indices++;
+	}
+
+	int operator()(const RTLIL::SigBit &bit, bool create = false)
+	{
+		return bit.wire == NULL ? -1 : (*this)(bit.wire, bit.offset, create);
+	}
+
+	RTLIL::SigBit bit(int index) const
+	{
+		assert(0 <= index && index < num_indices);
+		int lo = 0, hi = range_starts.size();
+		while (hi - lo > 1) {
+			int mid = (lo + hi) / 2;
+			if (range_starts[mid].first <= index)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		const std::pair<int, RTLIL::SigBit> &start = range_starts[lo];
+		return RTLIL::SigBit(start.second.wire, start.second.offset + index - start.first);
+	}
+
+};
+
+// SigPool is a set of wire bits, stored as a bitset over the SigBitIndex
+// numbering. first_hint is a lower bound for the index of the first bit
+// in the pool and makes repeated export_one()/del() calls linear.
+
 struct SigPool
 {
-	typedef std::pair<RTLIL::Wire*,int> bitDef_t;
-	std::set<bitDef_t> bits;
+	SigBitIndex index;
+	std::vector<bool> bits;
+	size_t bits_count;
+	size_t first_hint;
+
+	SigPool() : bits_count(0), first_hint(0) { }
 
 	void clear()
 	{
+		index.clear();
 		bits.clear();
+		bits_count = 0;
+		first_hint = 0;
 	}
 
-	void add(RTLIL::SigSpec sig)
+	// internal helper function
+	void add_bit(RTLIL::Wire *wire, int offset)
+	{
+		size_t idx = index(wire, offset, true);
+		if (idx >= bits.size())
+			bits.resize(index.size());
+		if (!bits[idx]) {
+			bits[idx] = true;
+			bits_count++;
+			first_hint = std::min(first_hint, idx);
+		}
+	}
+
+	// internal helper function
+	void del_bit(RTLIL::Wire *wire, int offset)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
-				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			bits.insert(bit);
+		int idx = index(wire, offset);
+		if (idx >= 0 && idx < int(bits.size()) && bits[idx]) {
+			bits[idx] = false;
+			bits_count--;
 		}
 	}
 
+	// internal helper function
+	bool has_bit(RTLIL::Wire *wire, int offset)
+	{
+		int idx = index(wire, offset);
+		return idx >= 0 && idx < int(bits.size()) && bits[idx];
+	}
+
+	void add(RTLIL::SigSpec sig)
+	{
+		for (auto &bit : sig.bits())
+			if (bit.wire != NULL)
+				add_bit(bit.wire, bit.offset);
+	}
+
 	void add(const SigPool &other)
 	{
-		for (auto &bit : other.bits)
-			bits.insert(bit);
+		for (size_t i = 0; i < other.bits.size(); i++)
+			if (other.bits[i]) {
+				RTLIL::SigBit bit = other.index.bit(i);
+				add_bit(bit.wire, bit.offset);
+			}
 	}
 
 	void del(RTLIL::SigSpec sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
-				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			bits.erase(bit);
-		}
+		for (auto &bit : sig.bits())
+			if (bit.wire != NULL)
+				del_bit(bit.wire, bit.offset);
 	}
 
 	void del(const SigPool &other)
 	{
-		for (auto &bit : other.bits)
-			bits.erase(bit);
+		for (size_t i = 0; i < other.bits.size(); i++)
+			if (other.bits[i]) {
+				RTLIL::SigBit bit = other.index.bit(i);
+				del_bit(bit.wire, bit.offset);
+			}
 	}
 
 	void expand(RTLIL::SigSpec from, RTLIL::SigSpec to)
 	{
-		from.expand();
-		to.expand();
-		assert(from.chunks.size() == to.chunks.size());
-		for (size_t i = 0; i < from.chunks.size(); i++) {
-			bitDef_t bit_from(from.chunks[i].wire, from.chunks[i].offset);
-			bitDef_t bit_to(to.chunks[i].wire, to.chunks[i].offset);
-			if (bit_from.first == NULL || bit_to.first == NULL)
+		assert(from.width == to.width);
+		for (int i = 0; i < from.width; i++) {
+			if (from[i].wire == NULL || to[i].wire == NULL)
 				continue;
-			if (bits.count(bit_from) > 0)
-				bits.insert(bit_to);
+			if (has_bit(from[i].wire, from[i].offset))
+				add_bit(to[i].wire, to[i].offset);
 		}
 	}
 
 	RTLIL::SigSpec extract(RTLIL::SigSpec sig)
 	{
 		RTLIL::SigSpec result;
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			bitDef_t bit(c.wire, c.offset);
-			if (bits.count(bit) > 0)
-				result.append(c);
+			if (has_bit(bit.wire, bit.offset))
+				result.append_bit(bit);
 		}
 		return result;
 	}
@@ -103,25 +233,21 @@ struct SigPool
 	RTLIL::SigSpec remove(RTLIL::SigSpec sig)
 	{
 		RTLIL::SigSpec result;
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			bitDef_t bit(c.wire, c.offset);
-			if (bits.count(bit) == 0)
-				result.append(c);
+			if (!has_bit(bit.wire, bit.offset))
+				result.append_bit(bit);
 		}
 		return result;
 	}
 
 	bool check_any(RTLIL::SigSpec sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			bitDef_t bit(c.wire, c.offset);
-			if (bits.count(bit) != 0)
+			if (has_bit(bit.wire, bit.offset))
 				return true;
 		}
 		return false;
@@ -129,12 +255,10 @@ struct SigPool
 
 	bool check_all(RTLIL::SigSpec sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			bitDef_t bit(c.wire, c.offset);
-			if (bits.count(bit) == 0)
+			if (!has_bit(bit.wire, bit.offset))
 				return false;
 		}
 		return true;
@@ -143,9 +267,11 @@ struct SigPool
 	RTLIL::SigSpec export_one()
 	{
 		RTLIL::SigSpec sig;
-		for (auto &bit : bits) {
-			sig.append(RTLIL::SigSpec(bit.first, 1, bit.second));
-			break;
+		if (bits_count > 0) {
+			while (!bits[first_hint])
+				first_hint++;
+			RTLIL::SigBit bit = index.bit(first_hint);
+			sig.append(RTLIL::SigSpec(bit.wire, 1, bit.offset));
 		}
 		return sig;
 	}
@@ -153,99 +279,132 @@ struct SigPool
 	RTLIL::SigSpec export_all()
 	{
 		RTLIL::SigSpec sig;
-		for (auto &bit : bits)
-			sig.append(RTLIL::SigSpec(bit.first, 1, bit.second));
+		for (size_t i = 0; i < bits.size(); i++)
+			if (bits[i]) {
+				RTLIL::SigBit bit = index.bit(i);
+				sig.append(RTLIL::SigSpec(bit.wire, 1, bit.offset));
+			}
 		sig.sort_and_unify();
 		return sig;
 	}
 
 	size_t size()
 	{
-		return bits.size();
+		return bits_count;
 	}
 };
 
+// SigSet stores a small vector of values for each wire bit in the
+// SigBitIndex numbering. Values are appended without a duplicate check;
+// a vector is sorted and made unique whenever its size reaches a power of
+// two, so duplicates never take up more than half of it.
+
 template <typename T, class Compare = std::less<T>>
 struct SigSet
 {
-	typedef std::pair<RTLIL::Wire*,int> bitDef_t;
-	std::map<bitDef_t, std::set<T, Compare>> bits;
+	SigBitIndex index;
+	std::vector<std::vector<T>> bits;
+
+	struct equiv_t {
+		bool operator()(const T &a, const T &b) const {
+			return !Compare()(a, b) && !Compare()(b, a);
+		}
+	};
+
+	struct is_equiv_t {
+		const T &data;
+		is_equiv_t(const T &data) : data(data) { }
+		bool operator()(const T &a) const {
+			return equiv_t()(a, data);
+		}
+	};
 
 	void clear()
 	{
+		index.clear();
 		bits.clear();
 	}
 
+	// internal helper function
+	std::vector<T> *lookup(const RTLIL::SigBit &bit, bool create)
+	{
+		int idx = index(bit.wire, bit.offset, create);
+		if (idx < 0)
+			return NULL;
+		if (idx >= int(bits.size())) {
+			if (!create)
+				return NULL;
+			bits.resize(index.size());
+		}
+		return &bits[idx];
+	}
+
+	// internal helper function
+	static void insert_value(std::vector<T> &vec, const T &data)
+	{
+		vec.push_back(data);
+		if (vec.size() >= 8 && (vec.size() & (vec.size()-1)) == 0) {
+			std::sort(vec.begin(), vec.end(), Compare());
+			vec.erase(std::unique(vec.begin(), vec.end(), equiv_t()), vec.end());
+		}
+	}
+
 	void insert(RTLIL::SigSpec sig, T data)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			bits[bit].insert(data);
+			insert_value(*lookup(bit, true), data);
 		}
 	}
 
 	void insert(RTLIL::SigSpec sig, const std::set<T> &data)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			bits[bit].insert(data.begin(), data.end());
+			std::vector<T> &vec = *lookup(bit, true);
+			for (auto &d : data)
+				insert_value(vec, d);
 		}
 	}
 
 	void erase(RTLIL::SigSpec sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			bits[bit].clear();
+			std::vector<T> *vec = lookup(bit, false);
+			if (vec != NULL)
+				vec->clear();
 		}
 	}
 
 	void erase(RTLIL::SigSpec sig, T data)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			bits[bit].erase(data);
+			std::vector<T> *vec = lookup(bit, false);
+			if (vec != NULL)
+				vec->erase(std::remove_if(vec->begin(), vec->end(), is_equiv_t(data)), vec->end());
 		}
 	}
 
 	void erase(RTLIL::SigSpec sig, const std::set<T> &data)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
-				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			bits[bit].erase(data.begin(), data.end());
-		}
+		for (auto &d : data)
+			erase(sig, d);
 	}
 
 	void find(RTLIL::SigSpec sig, std::set<T> &result)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			for (auto &data : bits[bit])
-				result.insert(data);
+			std::vector<T> *vec = lookup(bit, false);
+			if (vec != NULL)
+				result.insert(vec->begin(), vec->end());
 		}
 	}
 
@@ -258,29 +417,27 @@ struct SigSet
 
 	bool has(RTLIL::SigSpec sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks) {
-			if (c.wire == NULL)
+		for (auto &bit : sig.bits()) {
+			if (bit.wire == NULL)
 				continue;
-			assert(c.width == 1);
-			bitDef_t bit(c.wire, c.offset);
-			if (bits.count(bit))
+			std::vector<T> *vec = lookup(bit, false);
+			if (vec != NULL && !vec->empty())
 				return true;
 		}
 		return false;
 	}
 };
 
+// SigMap is a union-find structure over the wire bits it has seen. Each
+// registered bit points to a node in the union-find forest and the root node
+// of each class holds the signal the bits in the class are mapped to.
+
 struct SigMap
 {
-	typedef std::pair<RTLIL::Wire*,int> bitDef_t;
-
-	struct shared_bit_data_t {
-		RTLIL::SigChunk chunk;
-		std::set<bitDef_t> bits;
-	};
-
-	std::map<bitDef_t, shared_bit_data_t*> bits;
+	SigBitIndex index;
+	std::vector<int> bit_nodes;
+	std::vector<int> node_parent, node_size;
+	std::vector<RTLIL::SigBit> node_value;
 
 	SigMap(RTLIL::Module *module = NULL)
 	{
@@ -301,32 +458,29 @@ struct SigMap
 
 	void copy(const SigMap &other)
 	{
-		clear();
-		for (auto &bit : other.bits) {
-			bits[bit.first] = new shared_bit_data_t;
-			bits[bit.first]->chunk = bit.second->chunk;
-			bits[bit.first]->bits = bit.second->bits;
-		}
+		index = other.index;
+		bit_nodes = other.bit_nodes;
+		node_parent = other.node_parent;
+		node_size = other.node_size;
+		node_value = other.node_value;
 	}
 
 	void swap(SigMap &other)
 	{
-		bits.swap(other.bits);
-	}
-
-	~SigMap()
-	{
-		clear();
+		index.swap(other.index);
+		bit_nodes.swap(other.bit_nodes);
+		node_parent.swap(other.node_parent);
+		node_size.swap(other.node_size);
+		node_value.swap(other.node_value);
 	}
 
 	void clear()
 	{
-		std::set<shared_bit_data_t*> all_bd_ptr;
-		for (auto &it : bits)
-			all_bd_ptr.insert(it.second);
-		for (auto bd_ptr : all_bd_ptr)
-			delete bd_ptr;
-		bits.clear();
+		index.clear();
+		bit_nodes.clear();
+		node_parent.clear();
+		node_size.clear();
+		node_value.clear();
 	}
 
 	void set(RTLIL::Module *module)
@@ -337,134 +491,134 @@ struct SigMap
 	}
 
 	// internal helper function
-	void register_bit(const RTLIL::SigChunk &c)
-	{
-		assert(c.width == 1);
-		bitDef_t bit(c.wire, c.offset);
-		if (c.wire && bits.count(bit) == 0) {
-			shared_bit_data_t *bd = new shared_bit_data_t;
-			bd->chunk = c;
-			bd->bits.insert(bit);
-			bits[bit] = bd;
+	int find_node(int node)
+	{
+		while (node_parent[node] != node) {
+			node_parent[node] = node_parent[node_parent[node]];
+			node = node_parent[node];
 		}
+		return node;
 	}
 
 	// internal helper function
-	void unregister_bit(const RTLIL::SigChunk &c)
-	{
-		assert(c.width == 1);
-		bitDef_t bit(c.wire, c.offset);
-		if (c.wire && bits.count(bit) > 0) {
-			shared_bit_data_t *bd = bits[bit];
-			bd->bits.erase(bit);
-			if (bd->bits.size() == 0)
-				delete bd;
-			bits.erase(bit);
-		}
+	int lookup_bit(const RTLIL::SigBit &bit)
+	{
+		if (bit.wire == NULL)
+			return -1;
+		int idx = index(bit.wire, bit.offset);
+		return idx < 0 || idx >= int(bit_nodes.size()) ? -1 : bit_nodes[idx];
 	}
 
 	// internal helper function
-	void merge_bit(const RTLIL::SigChunk &c1, const RTLIL::SigChunk &c2)
-	{
-		assert(c1.wire != NULL && c2.wire != NULL);
-		assert(c1.width == 1 && c2.width == 1);
-
-		bitDef_t b1(c1.wire, c1.offset);
-		bitDef_t b2(c2.wire, c2.offset);
-
-		shared_bit_data_t *bd1 = bits[b1];
-		shared_bit_data_t *bd2 = bits[b2];
-		assert(bd1 != NULL && bd2 != NULL);
-
-		if (bd1 == bd2)
-			return;
-
-		if (bd1->bits.size() < bd2->bits.size())
-		{
-			for (auto &bit : bd1->bits)
-				bits[bit] = bd2;
-			bd2->bits.insert(bd1->bits.begin(), bd1->bits.end());
-			delete bd1;
-		}
-		else
-		{
-			bd1->chunk = bd2->chunk;
-			for (auto &bit : bd2->bits)
-				bits[bit] = bd1;
-			bd1->bits.insert(bd2->bits.begin(), bd2->bits.end());
-			delete bd2;
+	int register_bit(const RTLIL::SigBit &bit)
+	{
+		assert(bit.wire != NULL);
+		int idx = index(bit.wire, bit.offset, true);
+		if (idx >= int(bit_nodes.size()))
+			bit_nodes.resize(index.size(), -1);
+		if (bit_nodes[idx] < 0) {
+			bit_nodes[idx] = node_parent.size();
+			node_parent.push_back(node_parent.size());
+			node_size.push_back(1);
+			node_value.push_back(bit);
 		}
+		return bit_nodes[idx];
 	}
 
 	// internal helper function
-	void set_bit(const RTLIL::SigChunk &c1, const RTLIL::SigChunk &c2)
-	{
-		assert(c1.wire != NULL);
-		assert(c1.width == 1 && c2.width == 1);
-		bitDef_t bit(c1.wire, c1.offset);
-		assert(bits.count(bit) > 0);
-		bits[bit]->chunk = c2;
+	void unregister_bit(const RTLIL::SigBit &bit)
+	{
+		// the node stays in the forest so the other bits in
+		// the class remain connected, only the bit is detached
+		if (bit.wire != NULL) {
+			int idx = index(bit.wire, bit.offset);
+			if (idx >= 0 && idx < int(bit_nodes.size()))
+				bit_nodes[idx] = -1;
+		}
 	}
 
 	// internal helper function
-	void map_bit(RTLIL::SigChunk &c)
+	void merge_nodes(int n1, int n2)
 	{
-		assert(c.width == 1);
-		bitDef_t bit(c.wire, c.offset);
-		if (c.wire && bits.count(bit) > 0)
-			c = bits[bit]->chunk;
+		n1 = find_node(n1);
+		n2 = find_node(n2);
+
+		if (n1 == n2)
+			return;
+
+		// the merged class is always mapped to the value of the second class
+		RTLIL::SigBit value = node_value[n2];
+
+		if (node_size[n1] < node_size[n2])
+			std::swap(n1, n2);
+
+		node_parent[n2] = n1;
+		node_size[n1] += node_size[n2];
+		node_value[n1] = value;
 	}
 
 	void add(RTLIL::SigSpec from, RTLIL::SigSpec to)
 	{
-		from.expand();
-		to.expand();
-
-		assert(from.chunks.size() == to.chunks.size());
-		for (size_t i = 0; i < from.chunks.size(); i++)
+		assert(from.width == to.width);
+		for (int i = 0; i < from.width; i++)
 		{
-			RTLIL::SigChunk &cf = from.chunks[i];
-			RTLIL::SigChunk &ct = to.chunks[i];
+			const RTLIL::SigBit &bf = from[i];
+			const RTLIL::SigBit &bt = to[i];
 
-			if (cf.wire == NULL)
+			if (bf.wire == NULL)
 				continue;
 
-			register_bit(cf);
-			register_bit(ct);
+			int nf = register_bit(bf);
 
-			if (ct.wire != NULL)
-				merge_bit(cf, ct);
-			else
-				set_bit(cf, ct);
+			if (bt.wire != NULL) {
+				int nt = register_bit(bt);
+				merge_nodes(nf, nt);
+			} else
+				node_value[find_node(nf)] = bt;
 		}
 	}
 
 	void add(RTLIL::SigSpec sig)
 	{
-		sig.expand();
-		for (size_t i = 0; i < sig.chunks.size(); i++)
-		{
-			RTLIL::SigChunk &c = sig.chunks[i];
-			if (c.wire != NULL) {
-				register_bit(c);
-				set_bit(c, c);
+		for (auto &bit : sig.bits())
+			if (bit.wire != NULL) {
+				int n = register_bit(bit);
+				node_value[find_node(n)] = bit;
 			}
-		}
 	}
 
 	void del(RTLIL::SigSpec sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks)
-			unregister_bit(c);
+		for (auto &bit : sig.bits())
+			unregister_bit(bit);
 	}
 
 	void apply(RTLIL::SigSpec &sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks)
-			map_bit(c);
-		sig.optimize();
+		for (int i = 0; i < sig.width; i++) {
+			int n = lookup_bit(sig[i]);
+			if (n >= 0)
+				sig[i] = node_value[find_node(n)];
+		}
+	}
+
+	RTLIL::SigBit map_bit(const RTLIL::SigBit &bit)
+	{
+		if (bit.wire != NULL) {
+			int idx = index(bit.wire, bit.offset);
+			if (idx >= 0 && idx < int(bit_nodes.size()) && bit_nodes[idx] >= 0)
+				return node_value[find_node(bit_nodes[idx])];
+		}
+		return bit;
+	}
+
+	// returns a number that identifies the class of the bit (until the next call
+	// to add()), even if the class is driven by a constant, or -1 if the bit is
+	// not connected to any other signal
+	int class_id(const RTLIL::SigBit &bit)
+	{
+		int n = lookup_bit(bit);
+		return n < 0 ? -1 : find_node(n);
 	}
 
 	RTLIL::SigSpec operator()(RTLIL::SigSpec sig)
@@ -87,6 +87,8 @@ struct ConnectPass : public Pass {
 		if (!module->processes.empty())
 			log_cmd_error("Found processes in selected module.\n");
 
+		module = design->unshare_module(module->name);
+
 		bool flag_nounset = false, flag_nomap = false;
 		std::string set_lhs, set_rhs, unset_expr;
 		std::string port_cell, port_port, port_expr;
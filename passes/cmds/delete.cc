@@ -27,12 +27,13 @@ struct DeleteWireWorker
 	std::set<std::string> *delete_wires_p;
 
 	void operator()(RTLIL::SigSpec &sig) {
-		sig.optimize();
-		for (auto &c : sig.chunks)
+		std::vector<RTLIL::SigChunk> chunks = sig.chunks();
+		for (auto &c : chunks)
 			if (c.wire != NULL && delete_wires_p->count(c.wire->name)) {
 				c.wire = module->new_wire(c.width, NEW_ID);
 				c.offset = 0;
 			}
+		sig = chunks;
 	}
 };
 
@@ -159,7 +160,7 @@ struct DeletePass : public Pass {
 		}
 
 		for (auto &it : delete_mods) {
-			delete design->modules.at(it);
+			RTLIL::Design::release_module(design->modules.at(it));
 			design->modules.erase(it);
 		}
 	}
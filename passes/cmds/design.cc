@@ -46,7 +46,8 @@ struct DesignPass : public Pass {
 		log("\n");
 		log("    design -save <name>\n");
 		log("\n");
-		log("Save the current design under the given name.\n");
+		log("Save the current design under the given name. The saved design shares all\n");
+		log("modules with the current design, a module is only copied when it is modified.\n");
 		log("\n");
 		log("\n");
 		log("    design -stash <name>\n");
@@ -193,9 +194,13 @@ struct DesignPass : public Pass {
 				std::string trg_name = as_name.empty() ? mod->name : RTLIL::escape_id(as_name);
 
 				if (copy_to_design->modules.count(trg_name))
-					delete copy_to_design->modules.at(trg_name);
-				copy_to_design->modules[trg_name] = mod->clone();
-				copy_to_design->modules[trg_name]->name = trg_name;
+					RTLIL::Design::release_module(copy_to_design->modules.at(trg_name));
+				if (trg_name == mod->name) {
+					copy_to_design->modules[trg_name] = RTLIL::Design::share_module(mod);
+				} else {
+					copy_to_design->modules[trg_name] = mod->clone();
+					copy_to_design->modules[trg_name]->name = trg_name;
+				}
 			}
 		}
 
@@ -204,7 +209,7 @@ struct DesignPass : public Pass {
 			RTLIL::Design *design_copy = new RTLIL::Design;
 
 			for (auto &it : design->modules)
-				design_copy->modules[it.first] = it.second->clone();
+				design_copy->modules[it.first] = RTLIL::Design::share_module(it.second);
 
 			design_copy->selection_stack = design->selection_stack;
 			design_copy->selection_vars = design->selection_vars;
@@ -222,7 +227,7 @@ struct DesignPass : public Pass {
 		if (reset_mode || !load_name.empty() || push_mode || pop_mode)
 		{
 			for (auto &it : design->modules)
-				delete it.second;
+				RTLIL::Design::release_module(it.second);
 			design->modules.clear();
 
 			design->selection_stack.clear();
@@ -240,11 +245,14 @@ struct DesignPass : public Pass {
 				pushed_designs.pop_back();
 
 			for (auto &it : saved_design->modules)
-				design->modules[it.first] = it.second->clone();
+				design->modules[it.first] = RTLIL::Design::share_module(it.second);
 
 			design->selection_stack = saved_design->selection_stack;
 			design->selection_vars = saved_design->selection_vars;
 			design->selected_active_module = saved_design->selected_active_module;
+
+			if (pop_mode)
+				delete saved_design;
 		}
 	}
 } DesignPass;
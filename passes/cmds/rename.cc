@@ -110,7 +110,7 @@ struct RenamePass : public Pass {
 				if (!design->selected(module))
 					continue;
 
-				std::map<RTLIL::IdString, RTLIL::Wire*> new_wires;
+				HashMap<RTLIL::IdString, RTLIL::Wire*> new_wires;
 				for (auto &it : module->wires) {
 					if (it.first[0] == '$' && design->selected(module, it.second))
 						do it.second->name = stringf("\\_%d_", counter++);
@@ -119,7 +119,7 @@ struct RenamePass : public Pass {
 				}
 				module->wires.swap(new_wires);
 
-				std::map<RTLIL::IdString, RTLIL::Cell*> new_cells;
+				HashMap<RTLIL::IdString, RTLIL::Cell*> new_cells;
 				for (auto &it : module->cells) {
 					if (it.first[0] == '$' && design->selected(module, it.second))
 						do it.second->name = stringf("\\_%d_", counter++);
@@ -140,7 +140,7 @@ struct RenamePass : public Pass {
 				if (!design->selected(module))
 					continue;
 
-				std::map<RTLIL::IdString, RTLIL::Wire*> new_wires;
+				HashMap<RTLIL::IdString, RTLIL::Wire*> new_wires;
 				for (auto &it : module->wires) {
 					if (design->selected(module, it.second))
 						if (it.first[0] == '\\' && it.second->port_id == 0)
@@ -149,7 +149,7 @@ struct RenamePass : public Pass {
 				}
 				module->wires.swap(new_wires);
 
-				std::map<RTLIL::IdString, RTLIL::Cell*> new_cells;
+				HashMap<RTLIL::IdString, RTLIL::Cell*> new_cells;
 				for (auto &it : module->cells) {
 					if (design->selected(module, it.second))
 						if (it.first[0] == '\\')
@@ -170,7 +170,7 @@ struct RenamePass : public Pass {
 			if (!design->selected_active_module.empty())
 			{
 				if (design->modules.count(design->selected_active_module) > 0)
-					rename_in_module(design->modules.at(design->selected_active_module), from_name, to_name);
+					rename_in_module(design->unshare_module(design->selected_active_module), from_name, to_name);
 			}
 			else
 			{
@@ -178,7 +178,7 @@ struct RenamePass : public Pass {
 					if (mod.first == from_name || RTLIL::unescape_id(mod.first) == from_name) {
 						to_name = RTLIL::escape_id(to_name);
 						log("Renaming module %s to %s.\n", mod.first.c_str(), to_name.c_str());
-						RTLIL::Module *module = mod.second;
+						RTLIL::Module *module = design->unshare_module(mod.first);
 						design->modules.erase(module->name);
 						module->name = to_name;
 						design->modules[module->name] = module;
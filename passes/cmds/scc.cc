@@ -24,6 +24,7 @@
 #include "kernel/register.h"
 #include "kernel/celltypes.h"
 #include "kernel/sigtools.h"
+#include "kernel/modindex.h"
 #include "kernel/log.h"
 #include <stdlib.h>
 #include <stdio.h>
@@ -33,7 +34,6 @@ struct SccWorker
 {
 	RTLIL::Design *design;
 	RTLIL::Module *module;
-	SigMap sigmap;
 	CellTypes ct;
 
 	std::set<RTLIL::Cell*> workQueue;
@@ -97,7 +97,7 @@ struct SccWorker
 		}
 	}
 
-	SccWorker(RTLIL::Design *design, RTLIL::Module *module, bool allCellTypes, int maxDepth) : design(design), module(module), sigmap(module)
+	SccWorker(RTLIL::Design *design, RTLIL::Module *module, bool allCellTypes, int maxDepth) : design(design), module(module)
 	{
 		if (module->processes.size() > 0) {
 			log("Skipping module %s as it contains processes (run 'proc' pass first).\n", module->name.c_str());
@@ -111,8 +111,10 @@ struct SccWorker
 			ct.setup_stdcells();
 		}
 
+		ModIndex *index = module->index();
+		SigMap &sigmap = index->sigmap;
 		SigPool selectedSignals;
-		SigSet<RTLIL::Cell*> sigToNextCells;
+		std::map<RTLIL::Cell*, std::set<RTLIL::IdString>> cellInputPorts;
 
 		for (auto &it : module->wires)
 			if (design->selected(module, it.second))
@@ -144,8 +146,10 @@ struct SccWorker
 				RTLIL::SigSpec sig = selectedSignals.extract(sigmap(conn.second));
 				sig.sort_and_unify();
 
-				if (isInput)
+				if (isInput) {
 					inputSignals.append(sig);
+					cellInputPorts[cell].insert(conn.first);
+				}
 				if (isOutput)
 					outputSignals.append(sig);
 			}
@@ -155,11 +159,19 @@ struct SccWorker
 
 			cellToPrevSig[cell] = inputSignals;
 			cellToNextSig[cell] = outputSignals;
-			sigToNextCells.insert(inputSignals, cell);
 		}
 
 		for (auto cell : workQueue)
-			cellToNextCell[cell] = sigToNextCells.find(cellToNextSig[cell]);
+		for (auto &bit : cellToNextSig[cell].to_sigbit_vector()) {
+			ModIndex::BitInfo *info = index->query(bit);
+			if (info == NULL)
+				continue;
+			for (auto &pi : info->readers) {
+				auto it = cellInputPorts.find(pi.cell);
+				if (it != cellInputPorts.end() && it->second.count(pi.port) > 0)
+					cellToNextCell[cell].insert(pi.cell);
+			}
+		}
 
 		labelCounter = 0;
 		cellLabels.clear();
@@ -191,7 +203,7 @@ struct SccWorker
 			nextsig.sort_and_unify();
 			sig = prevsig.extract(nextsig);
 
-			for (auto &chunk : sig.chunks)
+			for (auto &chunk : sig.chunks())
 				if (chunk.wire != NULL)
 					sel.selected_members[module->name].insert(chunk.wire->name);
 		}
@@ -199,7 +211,10 @@ struct SccWorker
 };
 
 struct SccPass : public Pass {
-	SccPass() : Pass("scc", "detect strongly connected components (logic loops)") { }
+	SccPass() : Pass("scc", "detect strongly connected components (logic loops)") {
+		preserves_index = true;
+		read_only = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -47,7 +47,8 @@ struct setunset_t
 	}
 };
 
-static void do_setunset(std::map<RTLIL::IdString, RTLIL::Const> &attrs, std::vector<setunset_t> &list)
+template<typename T>
+static void do_setunset(T &attrs, std::vector<setunset_t> &list)
 {
 	for (auto &item : list)
 		if (item.unset)
@@ -47,10 +47,9 @@ struct SetundefWorker
 {
 	void operator()(RTLIL::SigSpec &sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks)
-			if (c.wire == NULL && c.data.bits.at(0) > RTLIL::State::S1)
-				c.data.bits.at(0) = next_bit();
+		for (int i = 0; i < sig.width; i++)
+			if (sig[i].wire == NULL && sig[i].data > RTLIL::State::S1)
+				sig[i].data = next_bit();
 		sig.optimize();
 	}
 };
@@ -141,7 +140,7 @@ struct SetundefPass : public Pass {
 						undriven_signals.del(sigmap(conn.second));
 
 				RTLIL::SigSpec sig = undriven_signals.export_all();
-				for (auto &c : sig.chunks) {
+				for (auto &c : sig.chunks()) {
 					RTLIL::SigSpec bits;
 					for (int i = 0; i < c.width; i++)
 						bits.append(next_bit());
@@ -78,7 +78,7 @@ struct ShowWorker
 	std::string nextColor(RTLIL::SigSpec sig, std::string defaultColor)
 	{
 		sig.sort_and_unify();
-		for (auto &c : sig.chunks) {
+		for (auto &c : sig.chunks()) {
 			if (c.wire != NULL)
 				for (auto &s : color_selections)
 					if (s.second.selected_members.count(module->name) > 0 && s.second.selected_members.at(module->name).count(c.wire->name) > 0)
@@ -173,13 +173,13 @@ struct ShowWorker
 	{
 		sig.optimize();
 
-		if (sig.chunks.size() == 0) {
+		if (sig.chunks().size() == 0) {
 			fprintf(f, "v%d [ label=\"\" ];\n", single_idx_count);
 			return stringf("v%d", single_idx_count++);
 		}
 
-		if (sig.chunks.size() == 1) {
-			RTLIL::SigChunk &c = sig.chunks[0];
+		if (sig.chunks().size() == 1) {
+			const RTLIL::SigChunk &c = sig.chunks()[0];
 			if (c.wire != NULL && design->selected_member(module->name, c.wire->name)) {
 				if (!range_check || c.wire->width == c.width)
 						return stringf("n%d", id2num(c.wire->name));
@@ -202,8 +202,8 @@ struct ShowWorker
 			sig.optimize();
 			int pos = sig.width-1;
 			int idx = single_idx_count++;
-			for (int i = int(sig.chunks.size())-1; i >= 0; i--) {
-				RTLIL::SigChunk &c = sig.chunks[i];
+			for (int i = int(sig.chunks().size())-1; i >= 0; i--) {
+				const RTLIL::SigChunk &c = sig.chunks()[i];
 				net = gen_signode_simple(c, false);
 				assert(!net.empty());
 				if (driver) {
@@ -427,12 +427,12 @@ struct ShowWorker
 		for (auto &conn : module->connections)
 		{
 			bool found_lhs_wire = false;
-			for (auto &c : conn.first.chunks) {
+			for (auto &c : conn.first.chunks()) {
 				if (c.wire == NULL || design->selected_member(module->name, c.wire->name))
 					found_lhs_wire = true;
 			}
 			bool found_rhs_wire = false;
-			for (auto &c : conn.second.chunks) {
+			for (auto &c : conn.second.chunks()) {
 				if (c.wire == NULL || design->selected_member(module->name, c.wire->name))
 					found_rhs_wire = true;
 			}
@@ -532,7 +532,10 @@ struct ShowWorker
 };
 
 struct ShowPass : public Pass {
-	ShowPass() : Pass("show", "generate schematics using graphviz") { }
+	ShowPass() : Pass("show", "generate schematics using graphviz") {
+		preserves_index = true;
+		read_only = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
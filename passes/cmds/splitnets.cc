@@ -62,10 +62,9 @@ struct SplitnetsWorker
 
 	void operator()(RTLIL::SigSpec &sig)
 	{
-		sig.expand();
-		for (auto &c : sig.chunks)
-			if (splitmap.count(c.wire) > 0)
-				c = splitmap.at(c.wire).at(c.offset);
+		for (int i = 0; i < sig.width; i++)
+			if (splitmap.count(sig[i].wire) > 0)
+				sig[i] = splitmap.at(sig[i].wire).at(sig[i].offset);
 		sig.optimize();
 	}
 };
@@ -144,7 +143,7 @@ struct SplitnetsPass : public Pass {
 						continue;
 
 					RTLIL::SigSpec sig = p.second.optimized();
-					for (auto &chunk : sig.chunks) {
+					for (auto &chunk : sig.chunks()) {
 						if (chunk.wire == NULL)
 							continue;
 						if (chunk.wire->port_id == 0 || flag_ports) {
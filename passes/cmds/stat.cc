@@ -139,7 +139,10 @@ namespace
 }
 
 struct StatPass : public Pass {
-	StatPass() : Pass("stat", "print some statistics") { }
+	StatPass() : Pass("stat", "print some statistics") {
+		preserves_index = true;
+		read_only = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -154,6 +157,10 @@ struct StatPass : public Pass {
 		log("        selected and a module has the 'top' attribute set, this module is used\n");
 		log("        default value for this option.\n");
 		log("\n");
+		log("    -mem\n");
+		log("        also print memory usage of the wire and cell object pools (for all\n");
+		log("        designs, not only the selected portion of the current design).\n");
+		log("\n");
 	}
 	virtual void execute(std::vector<std::string> args, RTLIL::Design *design)
 	{
@@ -161,6 +168,7 @@ struct StatPass : public Pass {
 
 		RTLIL::Module *top_mod = NULL;
 		std::map<RTLIL::IdString, statdata_t> mod_stat;
+		bool mem_mode = false;
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++)
@@ -171,6 +179,10 @@ struct StatPass : public Pass {
 				top_mod = design->modules.at(RTLIL::escape_id(args[++argidx]));
 				continue;
 			}
+			if (args[argidx] == "-mem") {
+				mem_mode = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -206,6 +218,21 @@ struct StatPass : public Pass {
 			data.log_data();
 		}
 
+		if (mem_mode)
+		{
+			RTLIL::PoolStats wire_stats, cell_stats;
+			RTLIL::get_pool_stats(wire_stats, cell_stats);
+
+			log("\n");
+			log("=== object pools ===\n");
+			log("\n");
+			log("   %-8s %10s %10s %10s %10s %12s %12s\n", "", "slot size", "live", "peak", "slots", "pool bytes", "malloc est.");
+			log("   %-8s %10zd %10zd %10zd %10zd %12zd %12zd\n", "wires", wire_stats.slot_size, wire_stats.live_objects,
+					wire_stats.peak_objects, wire_stats.total_slots, wire_stats.block_bytes, wire_stats.malloc_bytes);
+			log("   %-8s %10zd %10zd %10zd %10zd %12zd %12zd\n", "cells", cell_stats.slot_size, cell_stats.live_objects,
+					cell_stats.peak_objects, cell_stats.total_slots, cell_stats.block_bytes, cell_stats.malloc_bytes);
+		}
+
 		log("\n");
 	}
 } StatPass;
@@ -36,8 +36,8 @@ struct FsmOpt
 		assert(sig.width == 1);
 		sig.optimize();
 
-		RTLIL::Wire *wire = sig.chunks[0].wire;
-		int bit = sig.chunks[0].offset;
+		RTLIL::Wire *wire = sig.chunks()[0].wire;
+		int bit = sig.chunks()[0].offset;
 
 		if (!wire || wire->attributes.count("\\unused_bits") == 0)
 			return false;
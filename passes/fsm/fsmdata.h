@@ -142,16 +142,14 @@ struct FsmData
 		log("\n");
 		log("  Input signals:\n");
 		RTLIL::SigSpec sig_in = cell->connections["\\CTRL_IN"];
-		sig_in.expand();
-		for (size_t i = 0; i < sig_in.chunks.size(); i++)
-			log("  %3zd: %s\n", i, log_signal(sig_in.chunks[i]));
+		for (int i = 0; i < sig_in.width; i++)
+			log("  %3d: %s\n", i, log_signal(sig_in[i]));
 
 		log("\n");
 		log("  Output signals:\n");
 		RTLIL::SigSpec sig_out = cell->connections["\\CTRL_OUT"];
-		sig_out.expand();
-		for (size_t i = 0; i < sig_out.chunks.size(); i++)
-			log("  %3zd: %s\n", i, log_signal(sig_out.chunks[i]));
+		for (int i = 0; i < sig_out.width; i++)
+			log("  %3d: %s\n", i, log_signal(sig_out[i]));
 
 		log("\n");
 		log("  State encoding:\n");
@@ -235,7 +235,7 @@ static void hierarchy(RTLIL::Design *design, RTLIL::Module *top, bool purge_lib,
 			continue;
 		log("Removing unused module `%s'.\n", mod->name.c_str());
 		design->modules.erase(mod->name);
-		delete mod;
+		RTLIL::Design::release_module(mod);
 	}
 
 	log("Removed %zd unused modules.\n", del_modules.size());
@@ -374,7 +374,7 @@ struct HierarchyPass : public Pass {
 					log_cmd_error("Option -top requires an additional argument!\n");
 				top_mod = design->modules.count(RTLIL::escape_id(args[argidx])) ? design->modules.at(RTLIL::escape_id(args[argidx])) : NULL;
 				if (top_mod == NULL && design->modules.count("$abstract" + RTLIL::escape_id(args[argidx]))) {
-					std::map<RTLIL::IdString, RTLIL::Const> empty_parameters;
+					HashMap<RTLIL::IdString, RTLIL::Const> empty_parameters;
 					design->modules.at("$abstract" + RTLIL::escape_id(args[argidx]))->derive(design, empty_parameters);
 					top_mod = design->modules.count(RTLIL::escape_id(args[argidx])) ? design->modules.at(RTLIL::escape_id(args[argidx])) : NULL;
 				}
@@ -386,6 +386,11 @@ struct HierarchyPass : public Pass {
 		}
 		extra_args(args, argidx, design, false);
 
+		// hierarchy can modify and remove any module of the design
+		design->unshare_modules();
+		if (top_mod != NULL)
+			top_mod = design->modules.at(top_mod->name);
+
 		if (generate_mode) {
 			generate(design, generate_cells, generate_ports);
 			return;
@@ -463,7 +468,7 @@ struct HierarchyPass : public Pass {
 				RTLIL::Cell *cell = work.second;
 				log("Mapping positional arguments of cell %s.%s (%s).\n",
 						RTLIL::id2cstr(module->name), RTLIL::id2cstr(cell->name), RTLIL::id2cstr(cell->type));
-				std::map<RTLIL::IdString, RTLIL::SigSpec> new_connections;
+				HashMap<RTLIL::IdString, RTLIL::SigSpec> new_connections;
 				for (auto &conn : cell->connections)
 					if (conn.first[0] == '$' && '0' <= conn.first[1] && conn.first[1] <= '9') {
 						int id = atoi(conn.first.c_str()+1);
@@ -67,7 +67,7 @@ struct SubmodWorker
 
 	void flag_signal(RTLIL::SigSpec &sig, bool create, bool set_int_driven, bool set_int_used, bool set_ext_driven, bool set_ext_used)
 	{
-		for (auto &c : sig.chunks)
+		for (auto &c : sig.chunks())
 			if (c.wire != NULL)
 				flag_wire(c.wire, create, set_int_driven, set_int_used, set_ext_driven, set_ext_used);
 	}
@@ -163,12 +163,15 @@ struct SubmodWorker
 
 		for (RTLIL::Cell *cell : submod.cells) {
 			RTLIL::Cell *new_cell = new RTLIL::Cell(*cell);
-			for (auto &conn : new_cell->connections)
-				for (auto &c : conn.second.chunks)
+			for (auto &conn : new_cell->connections) {
+				std::vector<RTLIL::SigChunk> chunks = conn.second.chunks();
+				for (auto &c : chunks)
 					if (c.wire != NULL) {
 						assert(wire_flags.count(c.wire) > 0);
 						c.wire = wire_flags[c.wire].new_wire;
 					}
+				conn.second = chunks;
+			}
 			log("  cell %s (%s)\n", new_cell->name.c_str(), new_cell->type.c_str());
 			new_mod->cells[new_cell->name] = new_cell;
 			module->cells.erase(cell->name);
@@ -50,7 +50,7 @@ static void handle_memory(RTLIL::Module *module, RTLIL::Cell *memory)
 		RTLIL::Cell *cell = new RTLIL::Cell;
 		cell->name = NEW_ID;
 		cell->type = "$memrd";
-		cell->parameters["\\MEMID"] = mem_name;
+		cell->parameters["\\MEMID"] = RTLIL::Const(mem_name.str());
 		cell->parameters["\\ABITS"] = memory->parameters.at("\\ABITS");
 		cell->parameters["\\WIDTH"] = memory->parameters.at("\\WIDTH");
 		cell->parameters["\\CLK_ENABLE"] = RTLIL::SigSpec(memory->parameters.at("\\RD_CLK_ENABLE")).extract(i, 1).as_const();
@@ -67,7 +67,7 @@ static void handle_memory(RTLIL::Module *module, RTLIL::Cell *memory)
 		RTLIL::Cell *cell = new RTLIL::Cell;
 		cell->name = NEW_ID;
 		cell->type = "$memwr";
-		cell->parameters["\\MEMID"] = mem_name;
+		cell->parameters["\\MEMID"] = RTLIL::Const(mem_name.str());
 		cell->parameters["\\ABITS"] = memory->parameters.at("\\ABITS");
 		cell->parameters["\\WIDTH"] = memory->parameters.at("\\WIDTH");
 		cell->parameters["\\CLK_ENABLE"] = RTLIL::SigSpec(memory->parameters.at("\\WR_CLK_ENABLE")).extract(i, 1).as_const();
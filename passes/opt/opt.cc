@@ -23,15 +23,113 @@
 #include <stdlib.h>
 #include <stdio.h>
 
-bool OPT_DID_SOMETHING;
+thread_local bool OPT_DID_SOMETHING;
+OptWorklist *OPT_WORKLIST = NULL;
+
+OptWorklist::OptWorklist()
+{
+	ct.setup_internals();
+	ct.setup_internals_mem();
+	ct.setup_stdcells();
+	ct.setup_stdcells_mem();
+}
+
+void OptWorklist::add_change(RTLIL::Module *module, RTLIL::Cell *cell)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	changes_t &ch = changes[module];
+	ch.cells.push_back(cell);
+	for (auto &conn : cell->connections) {
+		bool is_output = !ct.cell_known(cell->type) || ct.cell_output(cell->type, conn.first);
+		bool is_input = !ct.cell_known(cell->type) || ct.cell_input(cell->type, conn.first);
+		for (auto &chunk : conn.second.chunks())
+			for (int i = 0; chunk.wire != NULL && i < chunk.width; i++) {
+				if (is_output)
+					ch.driven_bits.push_back(RTLIL::SigBit(chunk.wire, chunk.offset + i));
+				if (is_input)
+					ch.read_bits.push_back(RTLIL::SigBit(chunk.wire, chunk.offset + i));
+			}
+	}
+}
+
+void OptWorklist::add_change(RTLIL::Module *module, const RTLIL::SigSpec &sig)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	changes_t &ch = changes[module];
+	for (auto &chunk : sig.chunks())
+		for (int i = 0; chunk.wire != NULL && i < chunk.width; i++)
+			ch.driven_bits.push_back(RTLIL::SigBit(chunk.wire, chunk.offset + i));
+}
+
+bool OptWorklist::changed_cells(RTLIL::Module *module, std::string key, SigMap &sigmap, std::set<RTLIL::Cell*> &cells, bool read_bits)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	changes_t &ch = changes[module];
+	mark_t new_mark = { ch.cells.size(), ch.driven_bits.size(), ch.read_bits.size() };
+
+	auto it = marks.find(std::pair<RTLIL::Module*, std::string>(module, key));
+	if (it == marks.end()) {
+		marks[std::pair<RTLIL::Module*, std::string>(module, key)] = new_mark;
+		return false;
+	}
+
+	mark_t mark = it->second;
+	it->second = new_mark;
+
+	// bits are compared by their class in sigmap, so a cell is also selected if it
+	// is only connected to a changed signal through other wires. the cells and
+	// wires in the log may have been deleted since, so they are never dereferenced
+	std::set<RTLIL::Cell*> changed(ch.cells.begin() + mark.cells, ch.cells.end());
+	std::set<int> changed_classes;
+	std::set<RTLIL::SigBit> changed_bits;
+
+	auto add_bit = [&](const RTLIL::SigBit &bit) {
+		int id = sigmap.class_id(bit);
+		if (id < 0)
+			changed_bits.insert(bit);
+		else
+			changed_classes.insert(id);
+	};
+	for (size_t i = mark.driven_bits; i < ch.driven_bits.size(); i++)
+		add_bit(ch.driven_bits[i]);
+	for (size_t i = mark.read_bits; read_bits && i < ch.read_bits.size(); i++)
+		add_bit(ch.read_bits[i]);
+
+	if (changed.size() == 0 && changed_classes.size() == 0 && changed_bits.size() == 0)
+		return true;
+
+	for (auto &cell_it : module->cells)
+	{
+		RTLIL::Cell *cell = cell_it.second;
+		if (changed.count(cell) > 0) {
+			cells.insert(cell);
+			continue;
+		}
+		for (auto &conn : cell->connections)
+		for (auto &chunk : conn.second.chunks())
+		for (int i = 0; chunk.wire != NULL && i < chunk.width; i++) {
+			RTLIL::SigBit bit(chunk.wire, chunk.offset + i);
+			int id = sigmap.class_id(bit);
+			if (id < 0 ? changed_bits.count(bit) > 0 : changed_classes.count(id) > 0) {
+				cells.insert(cell);
+				goto next_cell;
+			}
+		}
+	next_cell:;
+	}
+
+	return true;
+}
 
 struct OptPass : public Pass {
-	OptPass() : Pass("opt", "perform simple optimizations") { }
+	OptPass() : Pass("opt", "perform simple optimizations") {
+		tracks_changes = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
 		log("\n");
-		log("    opt [-purge] [-mux_undef] [-mux_bool] [-undriven] [selection]\n");
+		log("    opt [-purge] [-mux_undef] [-mux_bool] [-undriven] [-incremental] [selection]\n");
 		log("\n");
 		log("This pass calls all the other opt_* passes in a useful order. This performs\n");
 		log("a series of trivial optimizations and cleanups. This pass executes the other\n");
@@ -49,11 +147,23 @@ struct OptPass : public Pass {
 		log("        opt_const [-mux_undef] [-mux_bool] [-undriven]\n");
 		log("    while [changed design]\n");
 		log("\n");
+		log("The opt_* passes skip modules that have not been modified since the last time\n");
+		log("the same pass ran on them without changing anything.\n");
+		log("\n");
+		log("    -incremental\n");
+		log("        the opt_* passes record the cells and signals they change, and each\n");
+		log("        pass (and each iteration within a pass) only revisits the cells that\n");
+		log("        are connected to changes it has not seen yet. Only the first call of\n");
+		log("        each pass looks at all cells. opt_clean still processes the whole\n");
+		log("        module. This gives the same results as the default mode but is\n");
+		log("        faster on large netlists.\n");
+		log("\n");
 	}
 	virtual void execute(std::vector<std::string> args, RTLIL::Design *design)
 	{
 		std::string opt_clean_args;
 		std::string opt_const_args;
+		bool incremental = false;
 
 		log_header("Executing OPT pass (performing simple optimizations).\n");
 		log_push();
@@ -76,6 +186,10 @@ struct OptPass : public Pass {
 				opt_const_args += " -undriven";
 				continue;
 			}
+			if (args[argidx] == "-incremental") {
+				incremental = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -83,21 +197,32 @@ struct OptPass : public Pass {
 		log_header("Optimizing in-memory representation of design.\n");
 		design->optimize();
 
-		Pass::call(design, "opt_const");
-		Pass::call(design, "opt_share -nomux");
-		while (1) {
-			OPT_DID_SOMETHING = false;
-			Pass::call(design, "opt_muxtree");
-			Pass::call(design, "opt_reduce");
-			Pass::call(design, "opt_share");
-			Pass::call(design, "opt_rmdff");
-			Pass::call(design, "opt_clean" + opt_clean_args);
-			Pass::call(design, "opt_const" + opt_const_args);
-			if (OPT_DID_SOMETHING == false)
-				break;
-			log_header("Rerunning OPT passes. (Maybe there is more to do..)\n");
+		OptWorklist worklist;
+		if (incremental)
+			OPT_WORKLIST = &worklist;
+
+		try {
+			Pass::call(design, "opt_const");
+			Pass::call(design, "opt_share -nomux");
+			while (1) {
+				OPT_DID_SOMETHING = false;
+				Pass::call(design, "opt_muxtree");
+				Pass::call(design, "opt_reduce");
+				Pass::call(design, "opt_share");
+				Pass::call(design, "opt_rmdff");
+				Pass::call(design, "opt_clean" + opt_clean_args);
+				Pass::call(design, "opt_const" + opt_const_args);
+				if (OPT_DID_SOMETHING == false)
+					break;
+				log_header("Rerunning OPT passes. (Maybe there is more to do..)\n");
+			}
+		} catch (...) {
+			OPT_WORKLIST = NULL;
+			throw;
 		}
 
+		OPT_WORKLIST = NULL;
+
 		log_header("Optimizing in-memory representation of design.\n");
 		design->optimize();
 
@@ -30,7 +30,7 @@
 using RTLIL::id2cstr;
 
 static CellTypes ct, ct_reg, ct_all;
-static int count_rm_cells, count_rm_wires;
+static thread_local int count_rm_cells, count_rm_wires;
 
 static void rmunused_module_cells(RTLIL::Module *module, bool verbose)
 {
@@ -90,6 +90,7 @@ static void rmunused_module_cells(RTLIL::Module *module, bool verbose)
 		if (verbose)
 			log("  removing unused `%s' cell `%s'.\n", cell->type.c_str(), cell->name.c_str());
 		OPT_DID_SOMETHING = true;
+		opt_log_change(module, cell);
 		module->cells.erase(cell->name);
 		count_rm_cells++;
 		delete cell;
@@ -108,11 +109,11 @@ static bool compare_signals(RTLIL::SigSpec &s1, RTLIL::SigSpec &s2, SigPool &reg
 {
 	assert(s1.width == 1);
 	assert(s2.width == 1);
-	assert(s1.chunks.size() == 1);
-	assert(s2.chunks.size() == 1);
+	assert(s1.chunks().size() == 1);
+	assert(s2.chunks().size() == 1);
 
-	RTLIL::Wire *w1 = s1.chunks[0].wire;
-	RTLIL::Wire *w2 = s2.chunks[0].wire;
+	RTLIL::Wire *w1 = s1.chunks()[0].wire;
+	RTLIL::Wire *w2 = s2.chunks()[0].wire;
 
 	if (w1 == NULL || w2 == NULL)
 		return w2 == NULL;
@@ -201,11 +202,18 @@ static void rmunused_module_signals(RTLIL::Module *module, bool purge_mode, bool
 	SigPool used_signals_nodrivers;
 	for (auto &it : module->cells) {
 		RTLIL::Cell *cell = it.second;
+		if (OPT_WORKLIST != NULL)
+			for (auto &it2 : cell->connections)
+				if (assign_map(it2.second) != it2.second) {
+					opt_log_change(module, cell);
+					break;
+				}
 		for (auto &it2 : cell->connections) {
 			assign_map.apply(it2.second);
 			used_signals.add(it2.second);
 			if (!ct.cell_output(cell->type, it2.first))
 				used_signals_nodrivers.add(it2.second);
+			it2.second.optimize();
 		}
 	}
 	for (auto &it : module->wires) {
@@ -233,14 +241,12 @@ static void rmunused_module_signals(RTLIL::Module *module, bool purge_mode, bool
 			if (!used_signals.check_any(s2) && wire->port_id == 0 && !wire->get_bool_attribute("\\keep")) {
 				del_wires.push_back(wire);
 			} else {
-				s1.expand();
-				s2.expand();
-				assert(s1.chunks.size() == s2.chunks.size());
+				assert(s1.width == s2.width);
 				RTLIL::SigSig new_conn;
-				for (size_t i = 0; i < s1.chunks.size(); i++)
-					if (s1.chunks[i] != s2.chunks[i]) {
-						new_conn.first.append(s1.chunks[i]);
-						new_conn.second.append(s2.chunks[i]);
+				for (int i = 0; i < s1.width; i++)
+					if (s1[i] != s2[i]) {
+						new_conn.first.append_bit(s1[i]);
+						new_conn.second.append_bit(s2[i]);
 					}
 				if (new_conn.first.width > 0) {
 					new_conn.first.optimize();
@@ -257,14 +263,13 @@ static void rmunused_module_signals(RTLIL::Module *module, bool purge_mode, bool
 		RTLIL::SigSpec sig = assign_map(RTLIL::SigSpec(wire));
 		if (!used_signals_nodrivers.check_any(sig)) {
 			std::string unused_bits;
-			sig.expand();
-			for (size_t i = 0; i < sig.chunks.size(); i++) {
-				if (sig.chunks[i].wire == NULL)
+			for (int i = 0; i < sig.width; i++) {
+				if (sig[i].wire == NULL)
 					continue;
 				if (!used_signals_nodrivers.check_any(sig)) {
 					if (!unused_bits.empty())
 						unused_bits += " ";
-					unused_bits += stringf("%zd", i);
+					unused_bits += stringf("%d", i);
 				}
 			}
 			if (unused_bits.empty() || wire->port_id != 0)
@@ -302,7 +307,9 @@ static void rmunused_module(RTLIL::Module *module, bool purge_mode, bool verbose
 }
 
 struct OptCleanPass : public Pass {
-	OptCleanPass() : Pass("opt_clean", "remove unused cells and wires") { }
+	OptCleanPass() : Pass("opt_clean", "remove unused cells and wires") {
+		tracks_changes = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -345,17 +352,42 @@ struct OptCleanPass : public Pass {
 		ct_reg.setup_internals_mem();
 		ct_reg.setup_stdcells_mem();
 
-		for (auto &mod_it : design->modules) {
-			if (!design->selected_whole_module(mod_it.first)) {
-				if (design->selected(mod_it.second))
-					log("Skipping module %s as it is only partially selected.\n", id2cstr(mod_it.second->name));
-				continue;
+		std::string mode = purge_mode ? "-purge" : "";
+		std::vector<RTLIL::Module*> modules;
+		for (auto &mod_it : design->modules)
+			if (design->selected(mod_it.second))
+				modules.push_back(mod_it.second);
+
+		bool orig_did_something = OPT_DID_SOMETHING;
+		std::vector<char> module_processed(modules.size()), module_changed(modules.size()), module_did_something(modules.size());
+
+		run_modules(modules, [&](int i)
+		{
+			RTLIL::Module *module = modules[i];
+			if (!design->selected_whole_module(module->name)) {
+				log("Skipping module %s as it is only partially selected.\n", id2cstr(module->name));
+				return;
 			}
-			if (mod_it.second->processes.size() > 0) {
-				log("Skipping module %s as it contains processes.\n", mod_it.second->name.c_str());
-			} else {
-				rmunused_module(mod_it.second, purge_mode, true);
+			if (module->processes.size() > 0) {
+				log("Skipping module %s as it contains processes.\n", module->name.c_str());
+				return;
 			}
+			if (at_fixpoint(design, module, mode))
+				return;
+			OPT_DID_SOMETHING = false;
+			count_rm_cells = 0;
+			count_rm_wires = 0;
+			rmunused_module(module, purge_mode, true);
+			module_processed[i] = true;
+			module_changed[i] = count_rm_cells + count_rm_wires != 0;
+			module_did_something[i] = OPT_DID_SOMETHING;
+		});
+
+		OPT_DID_SOMETHING = orig_did_something;
+		for (size_t i = 0; i < modules.size(); i++) {
+			if (module_processed[i])
+				module_done(design, modules[i], module_changed[i], mode);
+			OPT_DID_SOMETHING = OPT_DID_SOMETHING || module_did_something[i];
 		}
 
 		ct.clear();
@@ -393,8 +425,7 @@ struct CleanPass : public Pass {
 			}
 			break;
 		}
-		if (argidx < args.size())
-			extra_args(args, argidx, design);
+		extra_args(args, argidx, design);
 
 		ct.setup_internals();
 		ct.setup_internals_mem();
@@ -406,15 +437,32 @@ struct CleanPass : public Pass {
 
 		ct_all.setup(design);
 
+		std::vector<RTLIL::Module*> modules;
+		for (auto &mod_it : design->modules)
+			if (design->selected_whole_module(mod_it.first) && mod_it.second->processes.size() == 0)
+				modules.push_back(mod_it.second);
+
+		bool orig_did_something = OPT_DID_SOMETHING;
+		std::vector<int> module_rm_cells(modules.size()), module_rm_wires(modules.size());
+
+		run_modules(modules, [&](int i)
+		{
+			count_rm_cells = 0;
+			count_rm_wires = 0;
+			do {
+				OPT_DID_SOMETHING = false;
+				rmunused_module(modules[i], purge_mode, false);
+			} while (OPT_DID_SOMETHING);
+			module_rm_cells[i] = count_rm_cells;
+			module_rm_wires[i] = count_rm_wires;
+		});
+
+		OPT_DID_SOMETHING = orig_did_something;
 		count_rm_cells = 0;
 		count_rm_wires = 0;
-
-		for (auto &mod_it : design->modules) {
-			if (design->selected_whole_module(mod_it.first) && mod_it.second->processes.size() == 0)
-				do {
-					OPT_DID_SOMETHING = false;
-					rmunused_module(mod_it.second, purge_mode, false);
-				} while (OPT_DID_SOMETHING);
+		for (size_t i = 0; i < modules.size(); i++) {
+			count_rm_cells += module_rm_cells[i];
+			count_rm_wires += module_rm_wires[i];
 		}
 
 		if (count_rm_cells > 0 || count_rm_wires > 0)
@@ -27,7 +27,7 @@
 #include <stdio.h>
 #include <set>
 
-static bool did_something;
+static thread_local bool did_something;
 
 void replace_undriven(RTLIL::Design *design, RTLIL::Module *module)
 {
@@ -56,7 +56,7 @@ void replace_undriven(RTLIL::Design *design, RTLIL::Module *module)
 	all_signals.del(driven_signals);
 	RTLIL::SigSpec undriven_signals = all_signals.export_all();
 
-	for (auto &c : undriven_signals.chunks)
+	for (auto &c : undriven_signals.chunks())
 	{
 		RTLIL::SigSpec sig = c;
 
@@ -67,6 +67,7 @@ void replace_undriven(RTLIL::Design *design, RTLIL::Module *module)
 
 		log("Setting undriven signal in %s to undef: %s\n", RTLIL::id2cstr(module->name), log_signal(c));
 		module->connections.push_back(RTLIL::SigSig(c, RTLIL::SigSpec(RTLIL::State::Sx, c.width)));
+		opt_log_change(module, c);
 		OPT_DID_SOMETHING = true;
 	}
 }
@@ -78,6 +79,8 @@ void replace_cell(RTLIL::Module *module, RTLIL::Cell *cell, std::string info, st
 			cell->type.c_str(), cell->name.c_str(), info.c_str(),
 			module->name.c_str(), log_signal(Y), log_signal(out_val));
 	// ILANG_BACKEND::dump_cell(stderr, "--> ", cell);
+	opt_log_change(module, cell);
+	opt_log_change(module, out_val);
 	module->connections.push_back(RTLIL::SigSig(Y, out_val));
 	module->cells.erase(cell->name);
 	delete cell;
@@ -85,7 +88,7 @@ void replace_cell(RTLIL::Module *module, RTLIL::Cell *cell, std::string info, st
 	did_something = true;
 }
 
-void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool consume_x, bool mux_undef, bool mux_bool)
+void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool consume_x, bool mux_undef, bool mux_bool, std::string mode)
 {
 	if (!design->selected(module))
 		return;
@@ -93,14 +96,20 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 	SigMap assign_map(module);
 	std::map<RTLIL::SigSpec, RTLIL::SigSpec> invert_map;
 
+	// with "opt -incremental" only the cells near changes since the last scan in this mode
+	std::set<RTLIL::Cell*> changed_cells;
+	bool only_changed = OPT_WORKLIST != NULL && OPT_WORKLIST->changed_cells(module,
+			"opt_const" + mode + (consume_x ? " (consume_x)" : ""), assign_map, changed_cells);
+
 	std::vector<RTLIL::Cell*> cells;
-	cells.reserve(module->cells.size());
+	cells.reserve(only_changed ? changed_cells.size() : module->cells.size());
 	for (auto &cell_it : module->cells)
 		if (design->selected(module, cell_it.second)) {
 			if ((cell_it.second->type == "$_INV_" || cell_it.second->type == "$not" || cell_it.second->type == "$logic_not") &&
 					cell_it.second->connections["\\A"].width == 1 && cell_it.second->connections["\\Y"].width == 1)
 				invert_map[assign_map(cell_it.second->connections["\\Y"])] = assign_map(cell_it.second->connections["\\A"]);
-			cells.push_back(cell_it.second);
+			if (!only_changed || changed_cells.count(cell_it.second) > 0)
+				cells.push_back(cell_it.second);
 		}
 
 	for (auto cell : cells)
@@ -115,6 +124,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 		}
 
 		if ((cell->type == "$_MUX_" || cell->type == "$mux") && invert_map.count(assign_map(cell->connections["\\S"])) != 0) {
+			opt_log_change(module, cell);
 			RTLIL::SigSpec tmp = cell->connections["\\A"];
 			cell->connections["\\A"] = cell->connections["\\B"];
 			cell->connections["\\B"] = tmp;
@@ -197,6 +207,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 			if (input.match("  1")) ACTION_DO("\\Y", input.extract(1, 1));
 			if (input.match("01 ")) ACTION_DO("\\Y", input.extract(0, 1));
 			if (input.match("10 ")) {
+				opt_log_change(module, cell);
 				cell->type = "$_INV_";
 				cell->connections["\\A"] = input.extract(0, 1);
 				cell->connections.erase("\\B");
@@ -227,21 +238,20 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 			}
 
 			RTLIL::SigSpec new_a, new_b;
-			a.expand(), b.expand();
 
-			assert(a.chunks.size() == b.chunks.size());
-			for (size_t i = 0; i < a.chunks.size(); i++) {
-				if (a.chunks[i].wire == NULL && b.chunks[i].wire == NULL && a.chunks[i].data.bits[0] != b.chunks[i].data.bits[0] &&
-						a.chunks[i].data.bits[0] <= RTLIL::State::S1 && b.chunks[i].data.bits[0] <= RTLIL::State::S1) {
+			assert(a.width == b.width);
+			for (int i = 0; i < a.width; i++) {
+				if (a[i].wire == NULL && b[i].wire == NULL && a[i].data != b[i].data &&
+						a[i].data <= RTLIL::State::S1 && b[i].data <= RTLIL::State::S1) {
 					RTLIL::SigSpec new_y = RTLIL::SigSpec((cell->type == "$eq" || cell->type == "$eqx") ?  RTLIL::State::S0 : RTLIL::State::S1);
 					new_y.extend(cell->parameters["\\Y_WIDTH"].as_int(), false);
 					replace_cell(module, cell, "empty", "\\Y", new_y);
 					goto next_cell;
 				}
-				if (a.chunks[i] == b.chunks[i])
+				if (a[i] == b[i])
 					continue;
-				new_a.append(a.chunks[i]);
-				new_b.append(b.chunks[i]);
+				new_a.append_bit(a[i]);
+				new_b.append_bit(b[i]);
 			}
 
 			if (new_a.width == 0) {
@@ -252,6 +262,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 			}
 
 			if (new_a.width < a.width || new_b.width < b.width) {
+				opt_log_change(module, cell);
 				new_a.optimize();
 				new_b.optimize();
 				cell->connections["\\A"] = new_a;
@@ -268,6 +279,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 			RTLIL::SigSpec b = assign_map(cell->connections["\\B"]);
 
 			if (a.is_fully_const()) {
+				opt_log_change(module, cell);
 				RTLIL::SigSpec tmp;
 				tmp = a, a = b, b = tmp;
 				cell->connections["\\A"] = a;
@@ -279,6 +291,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 					RTLIL::SigSpec input = b;
 					ACTION_DO("\\Y", cell->connections["\\A"]);
 				} else {
+					opt_log_change(module, cell);
 					cell->type = "$not";
 					cell->parameters.erase("\\B_WIDTH");
 					cell->parameters.erase("\\B_SIGNED");
@@ -296,6 +309,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 
 		if (mux_bool && (cell->type == "$mux" || cell->type == "$_MUX_") &&
 				cell->connections["\\A"] == RTLIL::SigSpec(1, 1) && cell->connections["\\B"] == RTLIL::SigSpec(0, 1)) {
+			opt_log_change(module, cell);
 			cell->connections["\\A"] = cell->connections["\\S"];
 			cell->connections.erase("\\B");
 			cell->connections.erase("\\S");
@@ -313,6 +327,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 		}
 
 		if (consume_x && mux_bool && (cell->type == "$mux" || cell->type == "$_MUX_") && cell->connections["\\A"] == RTLIL::SigSpec(0, 1)) {
+			opt_log_change(module, cell);
 			cell->connections["\\A"] = cell->connections["\\S"];
 			cell->connections.erase("\\S");
 			if (cell->type == "$mux") {
@@ -331,6 +346,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 		}
 
 		if (consume_x && mux_bool && (cell->type == "$mux" || cell->type == "$_MUX_") && cell->connections["\\B"] == RTLIL::SigSpec(1, 1)) {
+			opt_log_change(module, cell);
 			cell->connections["\\B"] = cell->connections["\\S"];
 			cell->connections.erase("\\S");
 			if (cell->type == "$mux") {
@@ -379,6 +395,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 				goto next_cell;
 			}
 			if (cell->connections.at("\\S").width != new_s.width) {
+				opt_log_change(module, cell);
 				cell->connections.at("\\A") = new_a;
 				cell->connections.at("\\B") = new_b;
 				cell->connections.at("\\S") = new_s;
@@ -399,10 +416,8 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 			RTLIL::SigSpec a = cell->connections["\\A"]; \
 			assign_map.apply(a); \
 			if (a.is_fully_const()) { \
-				a.optimize(); \
-				if (a.chunks.empty()) a.chunks.push_back(RTLIL::SigChunk()); \
 				RTLIL::Const dummy_arg(RTLIL::State::S0, 1); \
-				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.chunks[0].data, dummy_arg, \
+				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.as_const(), dummy_arg, \
 						cell->parameters["\\A_SIGNED"].as_bool(), false, \
 						cell->parameters["\\Y_WIDTH"].as_int())); \
 				replace_cell(module, cell, stringf("%s", log_signal(a)), "\\Y", y); \
@@ -415,10 +430,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 			RTLIL::SigSpec b = cell->connections["\\B"]; \
 			assign_map.apply(a), assign_map.apply(b); \
 			if (a.is_fully_const() && b.is_fully_const()) { \
-				a.optimize(), b.optimize(); \
-				if (a.chunks.empty()) a.chunks.push_back(RTLIL::SigChunk()); \
-				if (b.chunks.empty()) b.chunks.push_back(RTLIL::SigChunk()); \
-				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.chunks[0].data, b.chunks[0].data, \
+				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.as_const(), b.as_const(), \
 						cell->parameters["\\A_SIGNED"].as_bool(), \
 						cell->parameters["\\B_SIGNED"].as_bool(), \
 						cell->parameters["\\Y_WIDTH"].as_int())); \
@@ -486,7 +498,9 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 }
 
 struct OptConstPass : public Pass {
-	OptConstPass() : Pass("opt_const", "perform const folding") { }
+	OptConstPass() : Pass("opt_const", "perform const folding") {
+		tracks_changes = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -532,18 +546,44 @@ struct OptConstPass : public Pass {
 		}
 		extra_args(args, argidx, design);
 
+		std::string mode;
+		if (mux_undef)
+			mode += " -mux_undef";
+		if (mux_bool)
+			mode += " -mux_bool";
+		if (undriven)
+			mode += " -undriven";
+
+		std::vector<RTLIL::Module*> modules;
 		for (auto &mod_it : design->modules)
+			if (design->selected(mod_it.second) && !at_fixpoint(design, mod_it.second, mode))
+				modules.push_back(mod_it.second);
+
+		bool orig_did_something = OPT_DID_SOMETHING;
+		std::vector<char> module_changed(modules.size());
+
+		run_modules(modules, [&](int i)
 		{
+			OPT_DID_SOMETHING = false;
+
 			if (undriven)
-				replace_undriven(design, mod_it.second);
+				replace_undriven(design, modules[i]);
 
 			do {
 				do {
 					did_something = false;
-					replace_const_cells(design, mod_it.second, false, mux_undef, mux_bool);
+					replace_const_cells(design, modules[i], false, mux_undef, mux_bool, mode);
 				} while (did_something);
-				replace_const_cells(design, mod_it.second, true, mux_undef, mux_bool);
+				replace_const_cells(design, modules[i], true, mux_undef, mux_bool, mode);
 			} while (did_something);
+
+			module_changed[i] = OPT_DID_SOMETHING;
+		});
+
+		OPT_DID_SOMETHING = orig_did_something;
+		for (size_t i = 0; i < modules.size(); i++) {
+			module_done(design, modules[i], module_changed[i], mode);
+			OPT_DID_SOMETHING = OPT_DID_SOMETHING || module_changed[i];
 		}
 
 		log_pop();
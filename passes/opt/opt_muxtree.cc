@@ -153,6 +153,28 @@ struct OptMuxtreeWorker
 					add_to_list(p.input_muxes, k);
 		}
 
+		// with "opt -incremental" only evaluate the groups of connected mux trees
+		// that contain a mux near a change since the last run
+		std::set<RTLIL::Cell*> changed_cells;
+		std::vector<bool> mux_changed(mux2info.size(), true);
+		if (OPT_WORKLIST != NULL && OPT_WORKLIST->changed_cells(module, "opt_muxtree", assign_map, changed_cells, true))
+		{
+			std::vector<int> group(mux2info.size());
+			for (size_t i = 0; i < mux2info.size(); i++)
+				group[i] = i;
+			for (size_t i = 0; i < mux2info.size(); i++)
+			for (auto &p : mux2info[i].ports)
+			for (int k : p.input_muxes)
+				group[find_group(group, i)] = find_group(group, k);
+
+			std::set<int> changed_groups;
+			for (size_t i = 0; i < mux2info.size(); i++)
+				if (changed_cells.count(mux2info[i].cell) > 0)
+					changed_groups.insert(find_group(group, i));
+			for (size_t i = 0; i < mux2info.size(); i++)
+				mux_changed[i] = changed_groups.count(find_group(group, i)) > 0;
+		}
+
 		log("  Evaluating internal representation of mux trees.\n");
 
 		std::set<int> root_muxes;
@@ -160,15 +182,20 @@ struct OptMuxtreeWorker
 			if (!bi.seen_non_mux)
 				continue;
 			for (int mux_idx : bi.mux_drivers)
-				root_muxes.insert(mux_idx);
+				if (mux_changed[mux_idx])
+					root_muxes.insert(mux_idx);
 		}
 		for (int mux_idx : root_muxes)
 			eval_root_mux(mux_idx);
 
 		log("  Analyzing evaluation results.\n");
 
-		for (auto &mi : mux2info)
+		for (size_t mux_idx = 0; mux_idx < mux2info.size(); mux_idx++)
 		{
+			muxinfo_t &mi = mux2info[mux_idx];
+			if (!mux_changed[mux_idx])
+				continue;
+
 			std::vector<int> live_ports;
 			for (size_t port_idx = 0; port_idx < mi.ports.size(); port_idx++) {
 				portinfo_t &pi = mi.ports[port_idx];
@@ -185,6 +212,8 @@ struct OptMuxtreeWorker
 			if (live_ports.size() == mi.ports.size())
 				continue;
 
+			opt_log_change(module, mi.cell);
+
 			if (live_ports.size() == 0) {
 				module->cells.erase(mi.cell->name);
 				delete mi.cell;
@@ -202,6 +231,7 @@ struct OptMuxtreeWorker
 			if (live_ports.size() == 1)
 			{
 				RTLIL::SigSpec sig_in = sig_ports.extract(live_ports[0]*sig_a.width, sig_a.width);
+				opt_log_change(module, sig_in);
 				module->connections.push_back(RTLIL::SigSig(sig_y, sig_in));
 				module->cells.erase(mi.cell->name);
 				delete mi.cell;
@@ -233,6 +263,13 @@ struct OptMuxtreeWorker
 		}
 	}
 
+	int find_group(std::vector<int> &group, int idx)
+	{
+		while (group[idx] != idx)
+			idx = group[idx] = group[group[idx]];
+		return idx;
+	}
+
 	bool list_is_subset(const std::vector<int> &sub, const std::vector<int> &super)
 	{
 		for (int v : sub)
@@ -259,10 +296,9 @@ struct OptMuxtreeWorker
 	{
 		std::vector<int> results;
 		assign_map.apply(sig);
-		sig.expand();
-		for (auto &c : sig.chunks)
-			if (c.wire != NULL) {
-				bitDef_t bit(c.wire, c.offset);
+		for (auto &sigbit : sig.bits())
+			if (sigbit.wire != NULL) {
+				bitDef_t bit(sigbit.wire, sigbit.offset);
 				if (bit2num.count(bit) == 0) {
 					bitinfo_t info;
 					info.num = bit2info.size();
@@ -403,7 +439,9 @@ struct OptMuxtreeWorker
 };
 
 struct OptMuxtreePass : public Pass {
-	OptMuxtreePass() : Pass("opt_muxtree", "eliminate dead trees in multiplexer trees") { }
+	OptMuxtreePass() : Pass("opt_muxtree", "eliminate dead trees in multiplexer trees") {
+		tracks_changes = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -431,9 +469,10 @@ struct OptMuxtreePass : public Pass {
 			}
 			if (mod_it.second->processes.size() > 0) {
 				log("Skipping module %s as it contains processes.\n", id2cstr(mod_it.second->name));
-			} else {
+			} else if (!at_fixpoint(design, mod_it.second)) {
 				OptMuxtreeWorker worker(design, mod_it.second);
 				total_count += worker.removed_count;
+				module_done(design, mod_it.second, worker.removed_count > 0);
 			}
 		}
 		log("Removed %d multiplexer ports.\n", total_count);
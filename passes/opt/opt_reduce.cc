@@ -45,32 +45,31 @@ struct OptReduceWorker
 
 		RTLIL::SigSpec sig_a = assign_map(cell->connections["\\A"]);
 		sig_a.sort_and_unify();
-		sig_a.expand();
 
 		RTLIL::SigSpec new_sig_a;
-		for (auto &chunk : sig_a.chunks)
+		for (auto &bit : sig_a.bits())
 		{
-			if (chunk.wire == NULL && chunk.data.bits[0] == RTLIL::State::S0) {
+			if (bit.wire == NULL && bit.data == RTLIL::State::S0) {
 				if (cell->type == "$reduce_and") {
 					new_sig_a = RTLIL::SigSpec(RTLIL::State::S0);
 					break;
 				}
 				continue;
 			}
-			if (chunk.wire == NULL && chunk.data.bits[0] == RTLIL::State::S1) {
+			if (bit.wire == NULL && bit.data == RTLIL::State::S1) {
 				if (cell->type == "$reduce_or") {
 					new_sig_a = RTLIL::SigSpec(RTLIL::State::S1);
 					break;
 				}
 				continue;
 			}
-			if (chunk.wire == NULL) {
-				new_sig_a.append(chunk);
+			if (bit.wire == NULL) {
+				new_sig_a.append_bit(bit);
 				continue;
 			}
 
 			bool imported_children = false;
-			for (auto child_cell : drivers.find(chunk)) {
+			for (auto child_cell : drivers.find(bit)) {
 				if (child_cell->type == cell->type) {
 					opt_reduce(cells, drivers, child_cell);
 					new_sig_a.append(child_cell->connections["\\A"]);
@@ -78,7 +77,7 @@ struct OptReduceWorker
 				}
 			}
 			if (!imported_children)
-				new_sig_a.append(chunk);
+				new_sig_a.append_bit(bit);
 		}
 		new_sig_a.sort_and_unify();
 
@@ -89,6 +88,8 @@ struct OptReduceWorker
 			total_count++;
 		}
 
+		if (new_sig_a != cell->connections["\\A"])
+			opt_log_change(module, cell);
 		cell->connections["\\A"] = new_sig_a;
 		cell->parameters["\\A_WIDTH"] = RTLIL::Const(new_sig_a.width);
 		return;
@@ -134,6 +135,7 @@ struct OptReduceWorker
 
 				this_s = RTLIL::SigSpec(reduce_or_wire);
 				reduce_or_cell->connections["\\Y"] = this_s;
+				opt_log_change(module, reduce_or_cell);
 			}
 
 			new_sig_b.append(this_b);
@@ -150,6 +152,8 @@ struct OptReduceWorker
 
 		if (new_sig_s.width == 0)
 		{
+			opt_log_change(module, cell);
+			opt_log_change(module, cell->connections["\\A"]);
 			module->connections.push_back(RTLIL::SigSig(cell->connections["\\Y"], cell->connections["\\A"]));
 			assign_map.add(cell->connections["\\Y"], cell->connections["\\A"]);
 			module->cells.erase(cell->name);
@@ -157,6 +161,8 @@ struct OptReduceWorker
 		}
 		else
 		{
+			if (new_sig_b != cell->connections["\\B"] || new_sig_s != cell->connections["\\S"])
+				opt_log_change(module, cell);
 			cell->connections["\\B"] = new_sig_b;
 			cell->connections["\\S"] = new_sig_s;
 			if (new_sig_s.width > 1) {
@@ -180,6 +186,10 @@ struct OptReduceWorker
 		{
 			did_something = false;
 
+			// with "opt -incremental" only the cells near changes since the last iteration
+			std::set<RTLIL::Cell*> changed_cells;
+			bool only_changed = OPT_WORKLIST != NULL && OPT_WORKLIST->changed_cells(module, "opt_reduce", assign_map, changed_cells);
+
 			// merge trees of reduce_* cells to one single cell and unify input vectors
 			// (only handle recduce_and and reduce_or for various reasons)
 
@@ -194,7 +204,8 @@ struct OptReduceWorker
 					if (cell->type != type || !design->selected(module, cell))
 						continue;
 					drivers.insert(assign_map(cell->connections["\\Y"]), cell);
-					cells.insert(cell);
+					if (!only_changed || changed_cells.count(cell) > 0)
+						cells.insert(cell);
 				}
 
 				while (cells.size() > 0) {
@@ -210,6 +221,8 @@ struct OptReduceWorker
 				RTLIL::Cell *cell = cell_it.second;
 				if ((cell->type != "$mux" && cell->type != "$pmux" && cell->type != "$safe_pmux") || !design->selected(module, cell))
 					continue;
+				if (only_changed && changed_cells.count(cell) == 0)
+					continue;
 				opt_mux(cell);
 			}
 		}
@@ -217,7 +230,9 @@ struct OptReduceWorker
 };
 
 struct OptReducePass : public Pass {
-	OptReducePass() : Pass("opt_reduce", "simplify large MUXes and AND/OR gates") { }
+	OptReducePass() : Pass("opt_reduce", "simplify large MUXes and AND/OR gates") {
+		tracks_changes = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -240,10 +255,11 @@ struct OptReducePass : public Pass {
 
 		int total_count = 0;
 		for (auto &mod_it : design->modules) {
-			if (!design->selected(mod_it.second))
+			if (!design->selected(mod_it.second) || at_fixpoint(design, mod_it.second))
 				continue;
 			OptReduceWorker worker(design, mod_it.second);
 			total_count += worker.total_count;
+			module_done(design, mod_it.second, worker.total_count > 0);
 		}
 
 		log("Performed a total of %d changes.\n", total_count);
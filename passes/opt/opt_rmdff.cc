@@ -89,12 +89,12 @@ static bool handle_dff(RTLIL::Module *mod, RTLIL::Cell *dff)
 			RTLIL::SigSpec sig_b = assign_map(mux->connections.at("\\B"));
 			if (sig_a == sig_q && sig_b.is_fully_const()) {
 				RTLIL::SigSig conn(sig_q, sig_b);
-				mod->connections.push_back(conn);
+				mod->connect(conn);
 				goto delete_dff;
 			}
 			if (sig_b == sig_q && sig_a.is_fully_const()) {
 				RTLIL::SigSig conn(sig_q, sig_a);
-				mod->connections.push_back(conn);
+				mod->connect(conn);
 				goto delete_dff;
 			}
 		}
@@ -104,36 +104,36 @@ static bool handle_dff(RTLIL::Module *mod, RTLIL::Cell *dff)
 		if (val_rv.bits.size() == 0)
 			val_rv = val_init;
 		RTLIL::SigSig conn(sig_q, val_rv);
-		mod->connections.push_back(conn);
+		mod->connect(conn);
 		goto delete_dff;
 	}
 
 	if (sig_d.is_fully_undef() && sig_r.width && !has_init) {
 		RTLIL::SigSig conn(sig_q, val_rv);
-		mod->connections.push_back(conn);
+		mod->connect(conn);
 		goto delete_dff;
 	}
 
 	if (sig_d.is_fully_undef() && !sig_r.width && has_init) {
 		RTLIL::SigSig conn(sig_q, val_init);
-		mod->connections.push_back(conn);
+		mod->connect(conn);
 		goto delete_dff;
 	}
 
 	if (sig_d.is_fully_const() && !sig_r.width && !has_init) {
 		RTLIL::SigSig conn(sig_q, sig_d);
-		mod->connections.push_back(conn);
+		mod->connect(conn);
 		goto delete_dff;
 	}
 
 	if (sig_d == sig_q && !(sig_r.width && has_init)) {
 		if (sig_r.width) {
 			RTLIL::SigSig conn(sig_q, val_rv);
-			mod->connections.push_back(conn);
+			mod->connect(conn);
 		}
 		if (has_init) {
 			RTLIL::SigSig conn(sig_q, val_init);
-			mod->connections.push_back(conn);
+			mod->connect(conn);
 		}
 		goto delete_dff;
 	}
@@ -143,13 +143,16 @@ static bool handle_dff(RTLIL::Module *mod, RTLIL::Cell *dff)
 delete_dff:
 	log("Removing %s (%s) from module %s.\n", dff->name.c_str(), dff->type.c_str(), mod->name.c_str());
 	OPT_DID_SOMETHING = true;
-	mod->cells.erase(dff->name);
-	delete dff;
+	opt_log_change(mod, dff);
+	mod->remove(dff);
 	return true;
 }
 
 struct OptRmdffPass : public Pass {
-	OptRmdffPass() : Pass("opt_rmdff", "remove DFFs with constant inputs") { }
+	OptRmdffPass() : Pass("opt_rmdff", "remove DFFs with constant inputs") {
+		preserves_index = true;
+		tracks_changes = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -169,7 +172,7 @@ struct OptRmdffPass : public Pass {
 
 		for (auto &mod_it : design->modules)
 		{
-			if (!design->selected(mod_it.second))
+			if (!design->selected(mod_it.second) || at_fixpoint(design, mod_it.second))
 				continue;
 
 			assign_map.set(mod_it.second);
@@ -179,6 +182,10 @@ struct OptRmdffPass : public Pass {
 					dff_init_map.add(it.second, it.second->attributes.at("\\init"));
 			mux_drivers.clear();
 
+			// with "opt -incremental" only the cells near changes since the last run
+			std::set<RTLIL::Cell*> changed_cells;
+			bool only_changed = OPT_WORKLIST != NULL && OPT_WORKLIST->changed_cells(mod_it.second, "opt_rmdff", assign_map, changed_cells);
+
 			std::vector<std::string> dff_list;
 			for (auto &it : mod_it.second->cells) {
 				if (it.second->type == "$mux" || it.second->type == "$pmux") {
@@ -188,6 +195,8 @@ struct OptRmdffPass : public Pass {
 				}
 				if (!design->selected(mod_it.second, it.second))
 					continue;
+				if (only_changed && changed_cells.count(it.second) == 0)
+					continue;
 				if (it.second->type == "$_DFF_N_") dff_list.push_back(it.first);
 				if (it.second->type == "$_DFF_P_") dff_list.push_back(it.first);
 				if (it.second->type == "$_DFF_NN0_") dff_list.push_back(it.first);
@@ -202,11 +211,15 @@ struct OptRmdffPass : public Pass {
 				if (it.second->type == "$adff") dff_list.push_back(it.first);
 			}
 
+			int module_count = 0;
 			for (auto &id : dff_list) {
 				if (mod_it.second->cells.count(id) > 0 &&
 						handle_dff(mod_it.second, mod_it.second->cells[id]))
-					total_count++;
+					module_count++;
 			}
+
+			total_count += module_count;
+			module_done(design, mod_it.second, module_count > 0);
 		}
 
 		assign_map.clear();
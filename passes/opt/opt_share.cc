@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdio.h>
+#include <algorithm>
 #include <set>
 
 #define USE_CELL_HASH_CACHE
@@ -63,11 +64,19 @@ struct OptShareWorker
 
 		std::string hash_string = cell->type + "\n";
 
+		// sort parameters and connections by (interned) name, so the hash string
+		// does not depend on the order in which they have been created
+		std::vector<const std::pair<RTLIL::IdString, RTLIL::Const>*> params;
 		for (auto &it : cell->parameters)
-			hash_string += "P " + it.first + "=" + it.second.as_string() + "\n";
+			params.push_back(&it);
+		std::sort(params.begin(), params.end(), [](const std::pair<RTLIL::IdString, RTLIL::Const> *a,
+				const std::pair<RTLIL::IdString, RTLIL::Const> *b) { return a->first.index_ < b->first.index_; });
 
-		const std::map<RTLIL::IdString, RTLIL::SigSpec> *conn = &cell->connections;
-		std::map<RTLIL::IdString, RTLIL::SigSpec> alt_conn;
+		for (auto it : params)
+			hash_string += "P " + it->first + "=" + it->second.as_string() + "\n";
+
+		const HashMap<RTLIL::IdString, RTLIL::SigSpec> *conn = &cell->connections;
+		HashMap<RTLIL::IdString, RTLIL::SigSpec> alt_conn;
 
 		if (cell->type == "$and" || cell->type == "$or" || cell->type == "$xor" || cell->type == "$xnor" || cell->type == "$add" || cell->type == "$mul" ||
 				cell->type == "$logic_and" || cell->type == "$logic_or" || cell->type == "$_AND_" || cell->type == "$_OR_" || cell->type == "$_XOR_") {
@@ -91,13 +100,19 @@ struct OptShareWorker
 			conn = &alt_conn;
 		}
 
-		for (auto &it : *conn) {
-			if (ct.cell_output(cell->type, it.first))
+		std::vector<const std::pair<RTLIL::IdString, RTLIL::SigSpec>*> conns;
+		for (auto &it : *conn)
+			conns.push_back(&it);
+		std::sort(conns.begin(), conns.end(), [](const std::pair<RTLIL::IdString, RTLIL::SigSpec> *a,
+				const std::pair<RTLIL::IdString, RTLIL::SigSpec> *b) { return a->first.index_ < b->first.index_; });
+
+		for (auto it : conns) {
+			if (ct.cell_output(cell->type, it->first))
 				continue;
-			RTLIL::SigSpec sig = it.second;
+			RTLIL::SigSpec sig = it->second;
 			assign_map.apply(sig);
-			hash_string += "C " + it.first + "=";
-			for (auto &chunk : sig.chunks) {
+			hash_string += "C " + it->first + "=";
+			for (auto &chunk : sig.chunks()) {
 				if (chunk.wire)
 					hash_string += "{" + chunk.wire->name + " " +
 							int_to_hash_string(chunk.offset) + " " +
@@ -135,8 +150,8 @@ struct OptShareWorker
 			return true;
 		}
 
-		std::map<RTLIL::IdString, RTLIL::SigSpec> conn1 = cell1->connections;
-		std::map<RTLIL::IdString, RTLIL::SigSpec> conn2 = cell2->connections;
+		HashMap<RTLIL::IdString, RTLIL::SigSpec> conn1 = cell1->connections;
+		HashMap<RTLIL::IdString, RTLIL::SigSpec> conn2 = cell2->connections;
 
 		for (auto &it : conn1) {
 			if (ct.cell_output(cell1->type, it.first))
@@ -210,6 +225,24 @@ struct OptShareWorker
 		return false;
 	}
 
+	// identical cells have the same type and the same set of input bits, so two
+	// cells can only be merged if they have the same type and smallest input bit
+	std::pair<RTLIL::IdString, RTLIL::SigBit> share_key(const RTLIL::Cell *cell)
+	{
+		RTLIL::SigBit min_bit;
+		for (auto &it : cell->connections) {
+			if (ct.cell_output(cell->type, it.first))
+				continue;
+			for (auto &chunk : it.second.chunks())
+				for (int i = 0; chunk.wire != NULL && i < chunk.width; i++) {
+					RTLIL::SigBit bit = assign_map.map_bit(RTLIL::SigBit(chunk.wire, chunk.offset + i));
+					if (bit.wire != NULL && (min_bit.wire == NULL || bit < min_bit))
+						min_bit = bit;
+				}
+		}
+		return std::pair<RTLIL::IdString, RTLIL::SigBit>(cell->type, min_bit);
+	}
+
 	struct CompareCells {
 		OptShareWorker *that;
 		CompareCells(OptShareWorker *that) : that(that) {}
@@ -228,9 +261,9 @@ struct OptShareWorker
 		ct.setup_stdcells_mem();
 
 		if (mode_nomux) {
-			ct.cell_types.erase("$mux");
-			ct.cell_types.erase("$pmux");
-			ct.cell_types.erase("$safe_pmux");
+			ct.erase_type("$mux");
+			ct.erase_type("$pmux");
+			ct.erase_type("$safe_pmux");
 		}
 
 		log("Finding identical cells in module `%s'.\n", module->name.c_str());
@@ -247,11 +280,24 @@ struct OptShareWorker
 #ifdef USE_CELL_HASH_CACHE
 			cell_hash_cache.clear();
 #endif
+			// with "opt -incremental" only look at the cells that could be merged with a
+			// cell that has been changed since the last iteration
+			std::set<RTLIL::Cell*> changed_cells;
+			std::set<std::pair<RTLIL::IdString, RTLIL::SigBit>> changed_keys;
+			bool only_changed = OPT_WORKLIST != NULL && OPT_WORKLIST->changed_cells(module,
+					mode_nomux ? "opt_share -nomux" : "opt_share", assign_map, changed_cells);
+			for (auto cell : changed_cells)
+				if (ct.cell_known(cell->type) && design->selected(module, cell))
+					changed_keys.insert(share_key(cell));
+
 			std::vector<RTLIL::Cell*> cells;
-			cells.reserve(module->cells.size());
+			cells.reserve(only_changed ? changed_cells.size() : module->cells.size());
 			for (auto &it : module->cells) {
-				if (ct.cell_known(it.second->type) && design->selected(module, it.second))
-					cells.push_back(it.second);
+				if (!ct.cell_known(it.second->type) || !design->selected(module, it.second))
+					continue;
+				if (only_changed && (changed_keys.size() == 0 || changed_keys.count(share_key(it.second)) == 0))
+					continue;
+				cells.push_back(it.second);
 			}
 
 			did_something = false;
@@ -261,6 +307,7 @@ struct OptShareWorker
 				if (sharemap.count(cell) > 0) {
 					did_something = true;
 					log("  Cell `%s' is identical to cell `%s'.\n", cell->name.c_str(), sharemap[cell]->name.c_str());
+					opt_log_change(module, cell);
 					for (auto &it : cell->connections) {
 						if (ct.cell_output(cell->type, it.first)) {
 							RTLIL::SigSpec other_sig = sharemap[cell]->connections[it.first];
@@ -268,6 +315,7 @@ struct OptShareWorker
 									log_signal(it.second), log_signal(other_sig));
 							module->connections.push_back(RTLIL::SigSig(it.second, other_sig));
 							assign_map.add(it.second, other_sig);
+							opt_log_change(module, other_sig);
 						}
 					}
 					log("    Removing %s cell `%s' from module `%s'.\n", cell->type.c_str(), cell->name.c_str(), module->name.c_str());
@@ -284,7 +332,9 @@ struct OptShareWorker
 };
 
 struct OptSharePass : public Pass {
-	OptSharePass() : Pass("opt_share", "consolidate identical cells") { }
+	OptSharePass() : Pass("opt_share", "consolidate identical cells") {
+		tracks_changes = true;
+	}
 	virtual void help()
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -317,10 +367,11 @@ struct OptSharePass : public Pass {
 
 		int total_count = 0;
 		for (auto &mod_it : design->modules) {
-			if (!design->selected(mod_it.second))
+			if (!design->selected(mod_it.second) || at_fixpoint(design, mod_it.second, mode_nomux ? "-nomux" : ""))
 				continue;
 			OptShareWorker worker(design, mod_it.second, mode_nomux);
 			total_count += worker.total_count;
+			module_done(design, mod_it.second, worker.total_count > 0, mode_nomux ? "-nomux" : "");
 		}
 
 		log("Removed a total of %d cells.\n", total_count);
@@ -20,7 +20,67 @@
 #ifndef OPT_STATUS_H
 #define OPT_STATUS_H
 
-extern bool OPT_DID_SOMETHING;
+#include "kernel/rtlil.h"
+#include "kernel/sigtools.h"
+#include "kernel/celltypes.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+
+// thread-local, so that opt_* passes can use it as a per-module flag in the
+// workers of Pass::run_modules()
+extern thread_local bool OPT_DID_SOMETHING;
+
+// Change log for "opt -incremental": the opt_* passes report every cell they
+// modify or remove and every signal they connect to something new. Each pass
+// (and each iteration of the inner loop of a pass) then only looks at the cells
+// that are connected to changes it has not seen yet, instead of all cells of
+// the module. The first call for a given key always returns all cells.
+
+struct OptWorklist
+{
+	struct changes_t {
+		std::vector<RTLIL::Cell*> cells;
+		std::vector<RTLIL::SigBit> driven_bits, read_bits;
+	};
+
+	struct mark_t {
+		size_t cells, driven_bits, read_bits;
+	};
+
+	CellTypes ct;
+	std::map<RTLIL::Module*, changes_t> changes;
+	std::map<std::pair<RTLIL::Module*, std::string>, mark_t> marks;
+	// opt_const records changes from the worker threads of Pass::run_modules()
+	std::mutex mutex;
+
+	OptWorklist();
+	void add_change(RTLIL::Module *module, RTLIL::Cell *cell);
+	void add_change(RTLIL::Module *module, const RTLIL::SigSpec &sig);
+
+	// returns false (and leaves cells empty) if all cells must be considered,
+	// read_bits also selects the cells that share an input with a changed cell
+	bool changed_cells(RTLIL::Module *module, std::string key, SigMap &sigmap, std::set<RTLIL::Cell*> &cells, bool read_bits = false);
+};
+
+// NULL unless the opt_* passes are called from "opt -incremental"
+extern OptWorklist *OPT_WORKLIST;
+
+// call before modifying or removing a cell
+static inline void opt_log_change(RTLIL::Module *module, RTLIL::Cell *cell)
+{
+	if (OPT_WORKLIST != NULL)
+		OPT_WORKLIST->add_change(module, cell);
+}
+
+// call for the signals that are connected to a new driver
+static inline void opt_log_change(RTLIL::Module *module, const RTLIL::SigSpec &sig)
+{
+	if (OPT_WORKLIST != NULL)
+		OPT_WORKLIST->add_change(module, sig);
+}
 
 #endif
 
@@ -165,10 +165,9 @@ restart_proc_arst:
 				for (auto &action : sync->actions) {
 					RTLIL::SigSpec rspec = action.second;
 					RTLIL::SigSpec rval = RTLIL::SigSpec(RTLIL::State::Sm, rspec.width);
-					rspec.expand(), rval.expand();
-					for (int i = 0; i < int(rspec.chunks.size()); i++)
-						if (rspec.chunks[i].wire == NULL)
-							rval.chunks[i] = rspec.chunks[i];
+					for (int i = 0; i < rspec.width; i++)
+						if (rspec[i].wire == NULL)
+							rval[i] = rspec[i];
 					rspec.optimize(), rval.optimize();
 					RTLIL::SigSpec last_rval;
 					for (int count = 0; rval != last_rval; count++) {
@@ -238,42 +237,48 @@ struct ProcArstPass : public Pass {
 
 		extra_args(args, argidx, design);
 
+		std::vector<RTLIL::Module*> modules;
 		for (auto &mod_it : design->modules)
-			if (design->selected(mod_it.second)) {
-				SigMap assign_map(mod_it.second);
-				for (auto &proc_it : mod_it.second->processes) {
-					if (!design->selected(mod_it.second, proc_it.second))
-						continue;
-					proc_arst(mod_it.second, proc_it.second, assign_map);
-					if (global_arst.empty() || mod_it.second->wires.count(global_arst) == 0)
-						continue;
-					std::vector<RTLIL::SigSig> arst_actions;
-					for (auto sync : proc_it.second->syncs)
-						if (sync->type == RTLIL::SyncType::STp || sync->type == RTLIL::SyncType::STn)
-							for (auto &act : sync->actions) {
-								RTLIL::SigSpec arst_sig, arst_val;
-								for (auto &chunk : act.first.chunks)
-									if (chunk.wire && chunk.wire->attributes.count("\\init")) {
-										RTLIL::SigSpec value = chunk.wire->attributes.at("\\init");
-										value.extend(chunk.wire->width, false);
-										arst_sig.append(chunk);
-										arst_val.append(value.extract(chunk.offset, chunk.width));
-									}
-								if (arst_sig.width) {
-									log("Added global reset to process %s: %s <- %s\n",
-											proc_it.first.c_str(), log_signal(arst_sig), log_signal(arst_val));
-									arst_actions.push_back(RTLIL::SigSig(arst_sig, arst_val));
+			if (design->selected(mod_it.second))
+				modules.push_back(mod_it.second);
+
+		run_modules(modules, [&](int i)
+		{
+			RTLIL::Module *mod = modules[i];
+			SigMap assign_map(mod);
+			for (auto &proc_it : mod->processes) {
+				if (!design->selected(mod, proc_it.second))
+					continue;
+				proc_arst(mod, proc_it.second, assign_map);
+				if (global_arst.empty() || mod->wires.count(global_arst) == 0)
+					continue;
+				std::vector<RTLIL::SigSig> arst_actions;
+				for (auto sync : proc_it.second->syncs)
+					if (sync->type == RTLIL::SyncType::STp || sync->type == RTLIL::SyncType::STn)
+						for (auto &act : sync->actions) {
+							RTLIL::SigSpec arst_sig, arst_val;
+							for (auto &chunk : act.first.chunks())
+								if (chunk.wire && chunk.wire->attributes.count("\\init")) {
+									RTLIL::SigSpec value = chunk.wire->attributes.at("\\init");
+									value.extend(chunk.wire->width, false);
+									arst_sig.append(chunk);
+									arst_val.append(value.extract(chunk.offset, chunk.width));
 								}
+							if (arst_sig.width) {
+								log("Added global reset to process %s: %s <- %s\n",
+										proc_it.first.c_str(), log_signal(arst_sig), log_signal(arst_val));
+								arst_actions.push_back(RTLIL::SigSig(arst_sig, arst_val));
 							}
-					if (!arst_actions.empty()) {
-						RTLIL::SyncRule *sync = new RTLIL::SyncRule;
-						sync->type = global_arst_neg ? RTLIL::SyncType::ST0 : RTLIL::SyncType::ST1;
-						sync->signal = mod_it.second->wires.at(global_arst);
-						sync->actions = arst_actions;
-						proc_it.second->syncs.push_back(sync);
-					}
+						}
+				if (!arst_actions.empty()) {
+					RTLIL::SyncRule *sync = new RTLIL::SyncRule;
+					sync->type = global_arst_neg ? RTLIL::SyncType::ST0 : RTLIL::SyncType::ST1;
+					sync->signal = mod->wires.at(global_arst);
+					sync->actions = arst_actions;
+					proc_it.second->syncs.push_back(sync);
 				}
 			}
+		});
 	}
 } ProcArstPass;
  
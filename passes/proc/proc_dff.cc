@@ -141,7 +141,7 @@ static void gen_dffsr_complex(RTLIL::Module *mod, RTLIL::SigSpec sig_d, RTLIL::S
 	}
 
 	std::stringstream sstr;
-	sstr << "$procdff$" << (RTLIL::autoidx++);
+	sstr << "$procdff$" << RTLIL::next_autoidx();
 
 	RTLIL::Cell *cell = new RTLIL::Cell;
 	cell->name = sstr.str();
@@ -166,7 +166,7 @@ static void gen_dffsr(RTLIL::Module *mod, RTLIL::SigSpec sig_in, RTLIL::SigSpec
 		bool clk_polarity, bool set_polarity, RTLIL::SigSpec clk, RTLIL::SigSpec set, RTLIL::Process *proc)
 {
 	std::stringstream sstr;
-	sstr << "$procdff$" << (RTLIL::autoidx++);
+	sstr << "$procdff$" << RTLIL::next_autoidx();
 
 	RTLIL::SigSpec sig_set_inv = NEW_WIRE(mod, sig_in.width);
 	RTLIL::SigSpec sig_sr_set = NEW_WIRE(mod, sig_in.width);
@@ -225,7 +225,7 @@ static void gen_dff(RTLIL::Module *mod, RTLIL::SigSpec sig_in, RTLIL::Const val_
 		bool clk_polarity, bool arst_polarity, RTLIL::SigSpec clk, RTLIL::SigSpec *arst, RTLIL::Process *proc)
 {
 	std::stringstream sstr;
-	sstr << "$procdff$" << (RTLIL::autoidx++);
+	sstr << "$procdff$" << RTLIL::next_autoidx();
 
 	RTLIL::Cell *cell = new RTLIL::Cell;
 	cell->name = sstr.str();
@@ -381,7 +381,7 @@ static void proc_dff(RTLIL::Module *mod, RTLIL::Process *proc, ConstEval &ce)
 					sync_edge->signal, sync_level->signal, proc);
 		}
 		else
-			gen_dff(mod, insig, rstval.chunks[0].data, sig,
+			gen_dff(mod, insig, rstval.chunks()[0].data, sig,
 					sync_edge->type == RTLIL::SyncType::STp,
 					sync_level && sync_level->type == RTLIL::SyncType::ST1,
 					sync_edge->signal, sync_level ? &sync_level->signal : NULL, proc);
@@ -409,13 +409,18 @@ struct ProcDffPass : public Pass {
 
 		extra_args(args, 1, design);
 
+		std::vector<RTLIL::Module*> modules;
 		for (auto &mod_it : design->modules)
-			if (design->selected(mod_it.second)) {
-				ConstEval ce(mod_it.second);
-				for (auto &proc_it : mod_it.second->processes)
-					if (design->selected(mod_it.second, proc_it.second))
-						proc_dff(mod_it.second, proc_it.second, ce);
-			}
+			if (design->selected(mod_it.second))
+				modules.push_back(mod_it.second);
+
+		run_modules(modules, [&](int i)
+		{
+			ConstEval ce(modules[i]);
+			for (auto &proc_it : modules[i]->processes)
+				if (design->selected(modules[i], proc_it.second))
+					proc_dff(modules[i], proc_it.second, ce);
+		});
 	}
 } ProcDffPass;
  
@@ -60,13 +60,13 @@ static void proc_init(RTLIL::Module *mod, RTLIL::Process *proc)
 					log_cmd_error("Failed to get a constant init value for %s: %s\n", log_signal(lhs), log_signal(rhs));
 
 				int offset = 0;
-				for (size_t i = 0; i < lhs.chunks.size(); i++) {
-					if (lhs.chunks[i].wire == NULL)
+				for (size_t i = 0; i < lhs.chunks().size(); i++) {
+					if (lhs.chunks()[i].wire == NULL)
 						continue;
-					RTLIL::Wire *wire = lhs.chunks[i].wire;
-					RTLIL::SigSpec value = rhs.extract(offset, lhs.chunks[i].width);
+					RTLIL::Wire *wire = lhs.chunks()[i].wire;
+					RTLIL::SigSpec value = rhs.extract(offset, lhs.chunks()[i].width);
 					if (value.width != wire->width)
-						log_cmd_error("Init value is not for the entire wire: %s = %s\n", log_signal(lhs.chunks[i]), log_signal(value));
+						log_cmd_error("Init value is not for the entire wire: %s = %s\n", log_signal(lhs.chunks()[i]), log_signal(value));
 					log("  Setting init value: %s = %s\n", log_signal(wire), log_signal(value));
 					wire->attributes["\\init"] = value.as_const();
 					offset += wire->width;
@@ -104,11 +104,17 @@ struct ProcInitPass : public Pass {
 
 		extra_args(args, 1, design);
 
+		std::vector<RTLIL::Module*> modules;
 		for (auto &mod_it : design->modules)
 			if (design->selected(mod_it.second))
-				for (auto &proc_it : mod_it.second->processes)
-					if (design->selected(mod_it.second, proc_it.second))
-						proc_init(mod_it.second, proc_it.second);
+				modules.push_back(mod_it.second);
+
+		run_modules(modules, [&](int i)
+		{
+			for (auto &proc_it : modules[i]->processes)
+				if (design->selected(modules[i], proc_it.second))
+					proc_init(modules[i], proc_it.second);
+		});
 	}
 } ProcInitPass;
  
@@ -58,7 +58,7 @@ static void extract_core_signal(const RTLIL::CaseRule *cs, RTLIL::SigSpec &sig)
 static RTLIL::SigSpec gen_cmp(RTLIL::Module *mod, const RTLIL::SigSpec &signal, const std::vector<RTLIL::SigSpec> &compare, RTLIL::SwitchRule *sw)
 {
 	std::stringstream sstr;
-	sstr << "$procmux$" << (RTLIL::autoidx++);
+	sstr << "$procmux$" << RTLIL::next_autoidx();
 
 	RTLIL::Wire *cmp_wire = new RTLIL::Wire;
 	cmp_wire->name = sstr.str() + "_CMP";
@@ -68,13 +68,11 @@ static RTLIL::SigSpec gen_cmp(RTLIL::Module *mod, const RTLIL::SigSpec &signal,
 	for (auto comp : compare)
 	{
 		RTLIL::SigSpec sig = signal;
-		sig.expand();
-		comp.expand();
 
 		// get rid of don't-care bits
 		assert(sig.width == comp.width);
 		for (int i = 0; i < comp.width; i++)
-			if (comp.chunks[i].wire == NULL && comp.chunks[i].data.bits[0] == RTLIL::State::Sa) {
+			if (comp[i].wire == NULL && comp[i].data == RTLIL::State::Sa) {
 				sig.remove(i, 1);
 				comp.remove(i--, 1);
 			}
@@ -146,7 +144,7 @@ static RTLIL::SigSpec gen_mux(RTLIL::Module *mod, const RTLIL::SigSpec &signal,
 	assert(when_signal.width == else_signal.width);
 
 	std::stringstream sstr;
-	sstr << "$procmux$" << (RTLIL::autoidx++);
+	sstr << "$procmux$" << RTLIL::next_autoidx();
 
 	// the trivial cases
 	if (compare.size() == 0 || when_signal == else_signal)
@@ -293,11 +291,17 @@ struct ProcMuxPass : public Pass {
 
 		extra_args(args, 1, design);
 
+		std::vector<RTLIL::Module*> modules;
 		for (auto &mod_it : design->modules)
 			if (design->selected(mod_it.second))
-				for (auto &proc_it : mod_it.second->processes)
-					if (design->selected(mod_it.second, proc_it.second))
-						proc_mux(mod_it.second, proc_it.second);
+				modules.push_back(mod_it.second);
+
+		run_modules(modules, [&](int i)
+		{
+			for (auto &proc_it : modules[i]->processes)
+				if (design->selected(modules[i], proc_it.second))
+					proc_mux(modules[i], proc_it.second);
+		});
 	}
 } ProcMuxPass;
  
@@ -78,22 +78,31 @@ struct ProcRmdeadPass : public Pass {
 
 		extra_args(args, 1, design);
 
-		int total_counter = 0;
-		for (auto &mod_it : design->modules) {
-			if (!design->selected(mod_it.second))
-				continue;
-			for (auto &proc_it : mod_it.second->processes) {
-				if (!design->selected(mod_it.second, proc_it.second))
+		std::vector<RTLIL::Module*> modules;
+		for (auto &mod_it : design->modules)
+			if (design->selected(mod_it.second))
+				modules.push_back(mod_it.second);
+
+		std::vector<int> module_counter(modules.size());
+		run_modules(modules, [&](int i)
+		{
+			RTLIL::Module *mod = modules[i];
+			for (auto &proc_it : mod->processes) {
+				if (!design->selected(mod, proc_it.second))
 					continue;
 				int counter = 0;
 				for (auto switch_it : proc_it.second->root_case.switches)
 					proc_rmdead(switch_it, counter);
 				if (counter > 0)
 					log("Removed %d dead cases from process %s in module %s.\n", counter,
-							proc_it.first.c_str(), mod_it.first.c_str());
-				total_counter += counter;
+							proc_it.first.c_str(), mod->name.c_str());
+				module_counter[i] += counter;
 			}
-		}
+		});
+
+		int total_counter = 0;
+		for (auto counter : module_counter)
+			total_counter += counter;
 
 		log("Removed a total of %d dead cases.\n", total_counter);
 	}
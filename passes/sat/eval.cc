@@ -70,11 +70,9 @@ struct BruteForceEquivChecker
 					log_signal(undef2), log_signal(mod1_inputs), log_signal(inputs));
 
 		if (ignore_x_mod1) {
-			sig1.expand(), sig2.expand();
-			for (size_t i = 0; i < sig1.chunks.size(); i++)
-				if (sig1.chunks.at(i) == RTLIL::SigChunk(RTLIL::State::Sx))
-					sig2.chunks.at(i) = RTLIL::SigChunk(RTLIL::State::Sx);
-			sig1.optimize(), sig2.optimize();
+			for (int i = 0; i < sig1.width; i++)
+				if (sig1[i] == RTLIL::SigBit(RTLIL::State::Sx))
+					sig2[i] = RTLIL::SigBit(RTLIL::State::Sx);
 		}
 
 		if (sig1 != sig2) {
@@ -171,10 +169,9 @@ struct VlogHammerReporter
 		if (!ez.solve(y_vec, y_values))
 			log_error("Failed to find solution to SAT problem.\n");
 
-		expected_y.expand();
 		for (int i = 0; i < expected_y.width; i++) {
 			RTLIL::State solution_bit = y_values.at(i) ? RTLIL::State::S1 : RTLIL::State::S0;
-			RTLIL::State expected_bit = expected_y.chunks.at(i).data.bits.at(0);
+			RTLIL::State expected_bit = expected_y[i].data;
 			if (model_undef) {
 				if (y_values.at(expected_y.width+i))
 					solution_bit = RTLIL::State::Sx;
@@ -189,8 +186,8 @@ struct VlogHammerReporter
 						sat_bits += "x";
 					else
 						sat_bits += y_values.at(k) ? "1" : "0";
-					rtl_bits += expected_y.chunks.at(k).data.bits.at(0) == RTLIL::State::Sx ? "x" :
-							expected_y.chunks.at(k).data.bits.at(0) == RTLIL::State::S1 ? "1" : "0";
+					rtl_bits += expected_y[k].data == RTLIL::State::Sx ? "x" :
+							expected_y[k].data == RTLIL::State::S1 ? "1" : "0";
 				}
 				log_error("Found error in SAT model: y[%d] = %s, should be %s:\n   SAT: %s\n   RTL: %s\n        %*s^\n",
 						int(i), log_signal(solution_bit), log_signal(expected_bit),
@@ -290,16 +287,14 @@ struct VlogHammerReporter
 
 				if (module_name == "rtl") {
 					rtl_sig = sig;
-					rtl_sig.expand();
 					sat_check(module, recorded_set_vars, recorded_set_vals, sig, false);
 					sat_check(module, recorded_set_vars, recorded_set_vals, sig, true);
 				} else if (rtl_sig.width > 0) {
-					sig.expand();
 					if (rtl_sig.width != sig.width)
 						log_error("Output (y) has a different width in module %s compared to rtl!\n", RTLIL::id2cstr(module->name));
 					for (int i = 0; i < sig.width; i++)
-						if (rtl_sig.chunks.at(i).data.bits.at(0) == RTLIL::State::Sx)
-							sig.chunks.at(i).data.bits.at(0) = RTLIL::State::Sx;
+						if (rtl_sig[i].data == RTLIL::State::Sx)
+							sig[i].data = RTLIL::State::Sx;
 				}
 
 				log("++RPT++ %d%s %s %s\n", idx, input_pattern_list.c_str(), sig.as_const().as_string().c_str(), module_name.c_str());
@@ -526,10 +521,10 @@ struct EvalPass : public Pass {
 			}
 
 			std::vector<std::string> tab_line;
-			for (auto &c : tabsigs.chunks)
+			for (auto &c : tabsigs.chunks())
 				tab_line.push_back(log_signal(c));
 			tab_sep_colidx = tab_line.size();
-			for (auto &c : signal.chunks)
+			for (auto &c : signal.chunks())
 				tab_line.push_back(log_signal(c));
 			tab.push_back(tab_line);
 			tab_line.clear();
@@ -554,13 +549,13 @@ struct EvalPass : public Pass {
 				}
 
 				int pos = 0;
-				for (auto &c : tabsigs.chunks) {
+				for (auto &c : tabsigs.chunks()) {
 					tab_line.push_back(log_signal(RTLIL::SigSpec(tabvals).extract(pos, c.width)));
 					pos += c.width;
 				}
 
 				pos = 0;
-				for (auto &c : signal.chunks) {
+				for (auto &c : signal.chunks()) {
 					tab_line.push_back(log_signal(value.extract(pos, c.width)));
 					pos += c.width;
 				}
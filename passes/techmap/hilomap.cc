@@ -30,9 +30,9 @@ static RTLIL::SigChunk last_hi, last_lo;
 
 void hilomap_worker(RTLIL::SigSpec &sig)
 {
-	sig.expand();
-	for (auto &c : sig.chunks) {
-		if (c.wire == NULL && (c.data.bits.at(0) == RTLIL::State::S1) && !hicell_celltype.empty()) {
+	for (int i = 0; i < sig.width; i++) {
+		RTLIL::SigBit &bit = sig[i];
+		if (bit.wire == NULL && (bit.data == RTLIL::State::S1) && !hicell_celltype.empty()) {
 			if (!singleton_mode || last_hi.width == 0) {
 				last_hi = RTLIL::SigChunk(NEW_WIRE(module, 1));
 				RTLIL::Cell *cell = new RTLIL::Cell;
@@ -41,9 +41,9 @@ void hilomap_worker(RTLIL::SigSpec &sig)
 				cell->connections[RTLIL::escape_id(hicell_portname)] = last_hi;
 				module->add(cell);
 			}
-			c = last_hi;
+			bit = last_hi;
 		}
-		if (c.wire == NULL && (c.data.bits.at(0) == RTLIL::State::S0) && !locell_celltype.empty()) {
+		if (bit.wire == NULL && (bit.data == RTLIL::State::S0) && !locell_celltype.empty()) {
 			if (!singleton_mode || last_lo.width == 0) {
 				last_lo = RTLIL::SigChunk(NEW_WIRE(module, 1));
 				RTLIL::Cell *cell = new RTLIL::Cell;
@@ -52,10 +52,9 @@ void hilomap_worker(RTLIL::SigSpec &sig)
 				cell->connections[RTLIL::escape_id(locell_portname)] = last_lo;
 				module->add(cell);
 			}
-			c = last_lo;
+			bit = last_lo;
 		}
 	}
-	sig.optimize();
 }
 
 struct HilomapPass : public Pass {
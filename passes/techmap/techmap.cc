@@ -31,7 +31,7 @@
 // see simplemap.cc
 extern void simplemap_get_mappers(std::map<std::string, void(*)(RTLIL::Module*, RTLIL::Cell*)> &mappers);
 
-static void apply_prefix(std::string prefix, std::string &id)
+static void apply_prefix(std::string prefix, RTLIL::IdString &id)
 {
 	if (id[0] == '\\')
 		id = prefix + "." + id.substr(1);
@@ -41,20 +41,22 @@ static void apply_prefix(std::string prefix, std::string &id)
 
 static void apply_prefix(std::string prefix, RTLIL::SigSpec &sig, RTLIL::Module *module)
 {
-	for (size_t i = 0; i < sig.chunks.size(); i++) {
-		if (sig.chunks[i].wire == NULL)
+	std::vector<RTLIL::SigChunk> chunks = sig.chunks();
+	for (size_t i = 0; i < chunks.size(); i++) {
+		if (chunks[i].wire == NULL)
 			continue;
-		std::string wire_name = sig.chunks[i].wire->name;
+		RTLIL::IdString wire_name = chunks[i].wire->name;
 		apply_prefix(prefix, wire_name);
 		assert(module->wires.count(wire_name) > 0);
-		sig.chunks[i].wire = module->wires[wire_name];
+		chunks[i].wire = module->wires[wire_name];
 	}
+	sig = chunks;
 }
 
 struct TechmapWorker
 {
 	std::map<std::string, void(*)(RTLIL::Module*, RTLIL::Cell*)> simplemap_mappers;
-	std::map<std::pair<RTLIL::IdString, std::map<RTLIL::IdString, RTLIL::Const>>, RTLIL::Module*> techmap_cache;
+	std::map<std::pair<RTLIL::IdString, HashMap<RTLIL::IdString, RTLIL::Const>>, RTLIL::Module*> techmap_cache;
 	std::map<RTLIL::Module*, bool> techmap_do_cache;
 
 	struct TechmapWireData {
@@ -189,6 +191,7 @@ struct TechmapWorker
 			for (auto &it2 : c->connections) {
 				apply_prefix(cell->name, it2.second, module);
 				port_signal_map.apply(it2.second);
+				it2.second.optimize();
 			}
 			module->add(c);
 			design->select(module, c);
@@ -200,6 +203,8 @@ struct TechmapWorker
 			apply_prefix(cell->name, c.second, module);
 			port_signal_map.apply(c.first);
 			port_signal_map.apply(c.second);
+			c.first.optimize();
+			c.second.optimize();
 			module->connections.push_back(c);
 		}
 
@@ -237,7 +242,7 @@ struct TechmapWorker
 			{
 				std::string derived_name = tpl_name;
 				RTLIL::Module *tpl = map->modules[tpl_name];
-				std::map<RTLIL::IdString, RTLIL::Const> parameters = cell->parameters;
+				HashMap<RTLIL::IdString, RTLIL::Const> parameters = cell->parameters;
 
 				if (!flatten_mode)
 				{
@@ -319,7 +324,7 @@ struct TechmapWorker
 						}
 				}
 
-				std::pair<RTLIL::IdString, std::map<RTLIL::IdString, RTLIL::Const>> key(tpl_name, parameters);
+				std::pair<RTLIL::IdString, HashMap<RTLIL::IdString, RTLIL::Const>> key(tpl_name, parameters);
 				if (techmap_cache.count(key) > 0) {
 					tpl = techmap_cache[key];
 				} else {
@@ -686,7 +691,7 @@ struct FlattenPass : public Pass {
 					new_modules[mod_it.first] = mod_it.second;
 				} else {
 					log("Deleting now unused module %s.\n", RTLIL::id2cstr(mod_it.first));
-					delete mod_it.second;
+					RTLIL::Design::release_module(mod_it.second);
 				}
 			design->modules.swap(new_modules);
 		}
@@ -0,0 +1,167 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/register.h"
+#include "kernel/rtlil.h"
+#include "kernel/log.h"
+#include <stdlib.h>
+
+static uint32_t xorshift32_state;
+
+static uint32_t xorshift32(uint32_t limit)
+{
+	xorshift32_state ^= xorshift32_state << 13;
+	xorshift32_state ^= xorshift32_state >> 17;
+	xorshift32_state ^= xorshift32_state << 5;
+	return xorshift32_state % limit;
+}
+
+struct test_calc_args_t {
+	RTLIL::Const arg1, arg2;
+	bool signed1, signed2;
+	int result_len;
+};
+
+static RTLIL::Const random_const(bool with_undef)
+{
+	// mostly small constants (like most parameters and cell inputs), some
+	// wider than 64 bits to also cover the BigInteger fallback
+	int width = xorshift32(8) == 0 ? 1 + xorshift32(100) : 1 + xorshift32(32);
+	RTLIL::Const value(RTLIL::State::S0, width);
+	for (auto &bit : value.bits)
+		bit = with_undef && xorshift32(16) == 0 ? RTLIL::State::Sx : xorshift32(2) ? RTLIL::State::S1 : RTLIL::State::S0;
+	return value;
+}
+
+struct TestCalcPass : public Pass {
+	TestCalcPass() : Pass("test_calc", "test and benchmark the constant folding functions") { }
+	virtual void help()
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    test_calc [options]\n");
+		log("\n");
+		log("Evaluate the RTLIL::const_* functions (as used by opt_const, ConstEval and the\n");
+		log("AST simplifier) for random arguments, once with the native integer fast path and\n");
+		log("once with BigInteger arithmetic only. An error is generated if the results do\n");
+		log("not match, and the run times of both implementations are reported.\n");
+		log("\n");
+		log("    -n <number>\n");
+		log("        number of random argument sets per function (default = 100000)\n");
+		log("\n");
+		log("    -seed <seed>\n");
+		log("        seed for the random number generator (default = 1)\n");
+		log("\n");
+		log("    -undef\n");
+		log("        also generate arguments with undefined bits\n");
+		log("\n");
+	}
+	virtual void execute(std::vector<std::string> args, RTLIL::Design*)
+	{
+		int num_tests = 100000;
+		uint32_t seed = 1;
+		bool with_undef = false;
+
+		log_header("Executing TEST_CALC pass (test constant folding functions).\n");
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++)
+		{
+			if (args[argidx] == "-n" && argidx+1 < args.size()) {
+				num_tests = atoi(args[++argidx].c_str());
+				continue;
+			}
+			if (args[argidx] == "-seed" && argidx+1 < args.size()) {
+				seed = atoi(args[++argidx].c_str());
+				continue;
+			}
+			if (args[argidx] == "-undef") {
+				with_undef = true;
+				continue;
+			}
+			break;
+		}
+		if (argidx != args.size())
+			cmd_error(args, argidx, "Extra argument.");
+
+		xorshift32_state = seed ? seed : 1;
+
+		std::vector<test_calc_args_t> test_args(num_tests);
+		for (auto &it : test_args) {
+			it.arg1 = random_const(with_undef);
+			it.arg2 = random_const(with_undef);
+			it.signed1 = xorshift32(2) != 0;
+			it.signed2 = it.signed1 || xorshift32(2) != 0;
+			it.result_len = xorshift32(8) == 0 ? 1 + xorshift32(100) : 1 + xorshift32(32);
+		}
+
+		std::vector<std::pair<std::string, RTLIL::Const(*)(const RTLIL::Const&, const RTLIL::Const&, bool, bool, int)>> funcs;
+		funcs.push_back(std::make_pair("$shl", RTLIL::const_shl));
+		funcs.push_back(std::make_pair("$shr", RTLIL::const_shr));
+		funcs.push_back(std::make_pair("$sshl", RTLIL::const_sshl));
+		funcs.push_back(std::make_pair("$sshr", RTLIL::const_sshr));
+		funcs.push_back(std::make_pair("$lt", RTLIL::const_lt));
+		funcs.push_back(std::make_pair("$le", RTLIL::const_le));
+		funcs.push_back(std::make_pair("$ge", RTLIL::const_ge));
+		funcs.push_back(std::make_pair("$gt", RTLIL::const_gt));
+		funcs.push_back(std::make_pair("$add", RTLIL::const_add));
+		funcs.push_back(std::make_pair("$sub", RTLIL::const_sub));
+		funcs.push_back(std::make_pair("$mul", RTLIL::const_mul));
+		funcs.push_back(std::make_pair("$div", RTLIL::const_div));
+		funcs.push_back(std::make_pair("$mod", RTLIL::const_mod));
+		funcs.push_back(std::make_pair("$pow", RTLIL::const_pow));
+		funcs.push_back(std::make_pair("$neg", RTLIL::const_neg));
+
+		log("\n%-8s %12s %12s %8s\n", "", "fast path", "BigInteger", "speedup");
+
+		for (auto &func : funcs)
+		{
+			std::vector<RTLIL::Const> fast_results, big_results;
+			fast_results.reserve(num_tests);
+			big_results.reserve(num_tests);
+
+			PerformanceTimer fast_timer, big_timer;
+
+			fast_timer.sub();
+			for (auto &it : test_args)
+				fast_results.push_back(func.second(it.arg1, it.arg2, it.signed1, it.signed2, it.result_len));
+			fast_timer.add();
+
+			RTLIL::const_disable_fastpath = true;
+			big_timer.sub();
+			for (auto &it : test_args)
+				big_results.push_back(func.second(it.arg1, it.arg2, it.signed1, it.signed2, it.result_len));
+			big_timer.add();
+			RTLIL::const_disable_fastpath = false;
+
+			for (int i = 0; i < num_tests; i++)
+				if (fast_results[i] != big_results[i])
+					log_error("Mismatch for %s(%s, %s, %s, %s, %d): %s (fast path) != %s (BigInteger)\n", func.first.c_str(),
+							test_args[i].arg1.as_string().c_str(), test_args[i].arg2.as_string().c_str(),
+							test_args[i].signed1 ? "signed" : "unsigned", test_args[i].signed2 ? "signed" : "unsigned",
+							test_args[i].result_len, fast_results[i].as_string().c_str(), big_results[i].as_string().c_str());
+
+			log("%-8s %10.3f s %10.3f s %7.1fx\n", func.first.c_str(), fast_timer.sec(), big_timer.sec(),
+					fast_timer.sec() > 0 ? big_timer.sec() / fast_timer.sec() : 0.0);
+		}
+
+		log("\nAll %d tests per function passed.\n", num_tests);
+	}
+} TestCalcPass;
+